@@ -0,0 +1,524 @@
+#pragma once
+#include "Cell.h"
+#include "GameLogic.h"
+#include "Generation.h"
+#include "Journal.h"
+#include "Random.h"
+#include "Snapshot.h"
+#include "Topology.h"
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Minesweeper {
+
+    // Game for a board size fixed at compile time. Cells and counters live
+    // in std::arrays inside the object, neighbours come from a compile-time
+    // policy (see Topology.h) and neighbour loops are unrolled, so generating
+    // and playing a board allocates nothing (undo history aside).
+    // Buffer layout, generation steps and the default generator match Game:
+    // on the square topology the same seed and first click give the same
+    // board, and snapshots load into Game. Use Game for sizes not known at
+    // compile time.
+    template <unsigned int W, unsigned int H, typename TopologyPolicy = Square8>
+    class BasicGame {
+        static_assert(W > 0 && H > 0, "Board must not be empty");
+        static_assert(W * H >= 2, "Board must fit the safe zone");
+
+    public:
+        using Topology = TopologyPolicy;
+        static constexpr unsigned int Width = W;
+        static constexpr unsigned int Height = H;
+
+        // Start a new board; without a seed one is drawn from std::random_device
+        void initialize() {
+            std::random_device rd;
+            initialize(Seed{ (static_cast<std::uint64_t>(rd()) << 32) ^ rd() });
+        }
+
+        void initialize(Seed seedValue) {
+            seed = seedValue.value;
+            rng.seed(seed);
+
+            // Sentinel ring: revealed and mine-free, as in Game
+            Cell sentinel;
+            sentinel.setState(CellState::Revealed);
+            grid.fill(sentinel);
+            neighbourCounts.fill(0);
+            for (unsigned int y = 0; y < H; ++y) {
+                for (unsigned int x = 0; x < W; ++x)
+                    grid[index(x, y)] = Cell{};
+            }
+            for (unsigned int y = 0; y < H; ++y) {
+                for (unsigned int x = 0; x < W; ++x) {
+                    const std::uint32_t i = index(x, y);
+                    unsigned int hidden = 0;
+                    forEachNeighbour(i, [&](std::uint32_t n) { hidden += grid[n].state() == CellState::Hidden; });
+                    neighbourCounts[i] = static_cast<std::uint8_t>(hidden << 4);
+                }
+            }
+
+            mineCount = 0;
+            firstClickPos = { 0, 0 };
+            revealedSafeCount = 0;
+            flagCount = 0;
+            questionCount = 0;
+            isInitialized = false;
+            gameOver = false;
+            journal.clear();
+        }
+
+        // Reveal the cell at (x, y); returns false if a mine was revealed
+        bool reveal(unsigned int x, unsigned int y, ChangeSet* changes = nullptr) {
+            MoveScope scope(*this, changes);
+            if (x >= W || y >= H) return true;
+
+            if (!isInitialized)
+                placeMines(x, y);
+
+            return revealCell(index(x, y));
+        }
+
+        // Cycle hidden -> flagged -> questioned -> hidden
+        void toggleFlag(unsigned int x, unsigned int y, ChangeSet* changes = nullptr) {
+            MoveScope scope(*this, changes);
+            if (x >= W || y >= H) return;
+
+            const std::uint32_t i = index(x, y);
+            switch (grid[i].state()) {
+            case CellState::Hidden:     setCellState(i, CellState::Flagged); break;
+            case CellState::Flagged:    setCellState(i, CellState::Questioned); break;
+            case CellState::Questioned: setCellState(i, CellState::Hidden); break;
+            default: break;
+            }
+        }
+
+        // Reveal the unflagged neighbours of a satisfied number, as Game::chord
+        bool chord(unsigned int x, unsigned int y, ChangeSet* changes = nullptr) {
+            MoveScope scope(*this, changes);
+            if (x >= W || y >= H || !isInitialized || gameOver) return true;
+
+            const std::uint32_t i = index(x, y);
+            const Cell& cell = grid[i];
+            if (cell.state() != CellState::Revealed || cell.hasMine() || cell.adjacentMines() == 0) return true;
+            if ((neighbourCounts[i] & 0x0F) != cell.adjacentMines()) return true;
+
+            bool safe = true;
+            forEachNeighbour(i, [&](std::uint32_t n) { safe &= revealCell(n); });
+            return safe;
+        }
+
+        // Flag around every number whose unrevealed neighbours must all be mines
+        void autoFlag(ChangeSet* changes = nullptr) {
+            MoveScope scope(*this, changes);
+            if (!isInitialized || gameOver) return;
+
+            for (unsigned int y = 0; y < H; ++y) {
+                for (unsigned int x = 0; x < W; ++x) {
+                    const std::uint32_t i = index(x, y);
+                    const Cell& cell = grid[i];
+                    if (cell.state() != CellState::Revealed || cell.hasMine()) continue;
+
+                    const unsigned int mines = cell.adjacentMines();
+                    if (mines == 0 || (neighbourCounts[i] >> 4) != mines || (neighbourCounts[i] & 0x0F) == mines) continue;
+
+                    forEachNeighbour(i, [&](std::uint32_t n) {
+                        const CellState state = grid[n].state();
+                        if (state == CellState::Hidden || state == CellState::Questioned)
+                            setCellState(n, CellState::Flagged);
+                    });
+                }
+            }
+        }
+
+        // Step back or forward through moves, as Game::undo and Game::redo
+        bool undo(ChangeSet* changes = nullptr) {
+            if (changes)
+                changes->clear();
+            const MoveJournal::Move* move = journal.undo();
+            if (!move) return false;
+
+            changeSink = changes;
+            for (auto run = move->runs.rbegin(); run != move->runs.rend(); ++run) {
+                for (std::uint64_t i = run->start; i < run->start + run->length; ++i)
+                    setCellState(static_cast<std::uint32_t>(i), run->before);
+            }
+            changeSink = nullptr;
+
+            gameOver = move->gameOverBefore;
+            return true;
+        }
+
+        bool redo(ChangeSet* changes = nullptr) {
+            if (changes)
+                changes->clear();
+            const MoveJournal::Move* move = journal.redo();
+            if (!move) return false;
+
+            changeSink = changes;
+            for (const MoveJournal::Run& run : move->runs) {
+                for (std::uint64_t i = run.start; i < run.start + run.length; ++i)
+                    setCellState(static_cast<std::uint32_t>(i), run.after);
+            }
+            changeSink = nullptr;
+
+            gameOver = move->gameOverAfter;
+            return true;
+        }
+
+        bool canUndo() const { return journal.canUndo(); }
+        bool canRedo() const { return journal.canRedo(); }
+
+        // Number of moves kept for undo (256 by default, 0 disables history)
+        void setHistoryDepth(std::size_t depth) { journal.setDepth(depth); }
+
+        bool checkWin() const { return revealedSafeCount == std::uint64_t(W) * H - mineCount; }
+        bool isGameOver() const { return gameOver; }
+        bool hasEnded() const { return gameOver || checkWin(); }
+
+        std::uint64_t getSeed() const { return seed; }
+
+        void setMineDensity(double density) {
+            if (density < 0.0 || density > 1.0)
+                throw std::invalid_argument("Mine density must be between 0 and 1.");
+            mineDensity = density;
+        }
+        double getMineDensity() const { return mineDensity; }
+        std::uint64_t getMineCount() const { return mineCount; }
+        std::int64_t remainingMines() const {
+            return static_cast<std::int64_t>(mineCount) - static_cast<std::int64_t>(flagCount);
+        }
+
+        // Snapshots in Game's format. Square boards load into Game as well;
+        // loading throws std::runtime_error on data that is damaged or made
+        // for another size or topology. Undo history is not included.
+        void loadSnapshot(const std::uint8_t* data, std::size_t size) {
+            SnapshotHeader header;
+            if (size < sizeof(header))
+                throw std::runtime_error("Snapshot is truncated.");
+            std::memcpy(&header, data, sizeof(header));
+
+            header.validate(Topology::Kind);
+            if (header.width != W || header.height != H)
+                throw std::runtime_error("Snapshot board size does not match.");
+            if (size - sizeof(header) < header.payloadSize)
+                throw std::runtime_error("Snapshot is truncated.");
+
+            const std::uint8_t* payload = data + sizeof(header);
+            if (!(header.flags & SnapshotHeader::Mapped)
+                && snapshotChecksum(payload, payload + BufferSize, BufferSize) != header.checksum)
+                throw std::runtime_error("Snapshot checksum mismatch.");
+
+            std::memcpy(grid.data(), payload, BufferSize);
+            std::memcpy(neighbourCounts.data(), payload + BufferSize, BufferSize);
+            firstClickPos = { header.firstClickX, header.firstClickY };
+            seed = header.seed;
+            rng.seed(seed);
+            mineCount = header.mineCount;
+            revealedSafeCount = header.revealedSafeCount;
+            flagCount = header.flagCount;
+            questionCount = header.questionCount;
+            isInitialized = (header.flags & SnapshotHeader::MinesPlaced) != 0;
+            gameOver = (header.flags & SnapshotHeader::GameOver) != 0;
+            mineDensity = header.mineDensity;
+            journal.clear();
+
+            // Game may have left counts of hidden cells to be filled in lazily
+            if (isInitialized)
+                computeAdjacency();
+        }
+
+        void loadSnapshot(const std::string& path) {
+            std::ifstream file(path, std::ios::binary);
+            if (!file)
+                throw std::runtime_error("Failed to open snapshot file.");
+            const std::vector<std::uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+            loadSnapshot(bytes.data(), bytes.size());
+        }
+
+        void saveSnapshot(std::vector<std::uint8_t>& out) const {
+            const SnapshotHeader header = makeSnapshotHeader();
+            out.resize(sizeof(header) + header.payloadSize);
+            std::memcpy(out.data(), &header, sizeof(header));
+            std::memcpy(out.data() + sizeof(header), grid.data(), BufferSize);
+            std::memcpy(out.data() + sizeof(header) + BufferSize, neighbourCounts.data(), BufferSize);
+        }
+
+        void saveSnapshot(const std::string& path) const {
+            std::vector<std::uint8_t> bytes;
+            saveSnapshot(bytes);
+
+            std::ofstream file(path, std::ios::binary | std::ios::trunc);
+            if (!file)
+                throw std::runtime_error("Failed to open snapshot file for writing.");
+            file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+            if (!file)
+                throw std::runtime_error("Failed to write snapshot file.");
+        }
+
+        GridView getGrid() const {
+            return GridView(grid.data() + Stride + 1, Stride, W, H);
+        }
+
+    private:
+        static constexpr std::uint32_t Stride = W + 2;
+        static constexpr std::size_t BufferSize = std::size_t(Stride) * (H + 2);
+        static constexpr std::size_t SafeZoneSize = 2;  // Game's safeParam
+
+        static constexpr std::uint32_t index(unsigned int x, unsigned int y) {
+            return (y + 1) * Stride + x + 1;
+        }
+
+        static constexpr bool isInterior(std::uint32_t i) {
+            return i % Stride - 1 < W && i / Stride - 1 < H;
+        }
+
+        static constexpr std::uint32_t neighbour(std::uint32_t i, std::size_t k) {
+            return Topology::template neighbour<W, H>(i, k);
+        }
+
+        // Calls f(n) for every neighbour of buffer index i, unrolled
+        template <typename F>
+        static void forEachNeighbour(std::uint32_t i, F&& f) {
+            [&]<std::size_t... K>(std::index_sequence<K...>) {
+                (f(neighbour(i, K)), ...);
+            }(std::make_index_sequence<Topology::Count>{});
+        }
+
+        // Brackets a public move like Game::MoveScope: the cells the move
+        // changes become one journal entry
+        struct MoveScope {
+            BasicGame& game;
+            bool gameOverBefore;
+
+            MoveScope(BasicGame& game, ChangeSet* changes) : game(game), gameOverBefore(game.gameOver) {
+                game.changeSink = changes;
+                game.journalling = true;
+                if (changes)
+                    changes->clear();
+            }
+
+            ~MoveScope() {
+                game.changeSink = nullptr;
+                game.journalling = false;
+                game.journal.commit(gameOverBefore, game.gameOver);
+            }
+        };
+
+        std::array<Cell, BufferSize> grid{};
+        std::array<std::uint8_t, BufferSize> neighbourCounts{};  // same encoding as Game
+        std::bitset<BufferSize> stencil;
+        std::array<std::uint32_t, std::size_t(W) * H> candidates{};
+        std::array<std::uint32_t, std::size_t(W) * H> fillStack{};
+        Xoshiro256 rng;
+        std::uint64_t seed = 0;
+        double mineDensity = 0.175;
+        std::uint64_t mineCount = 0;
+        std::uint64_t revealedSafeCount = 0, flagCount = 0, questionCount = 0;
+        std::pair<unsigned int, unsigned int> firstClickPos;
+        bool isInitialized = false;
+        bool gameOver = false;
+
+        ChangeSet* changeSink = nullptr;
+        MoveJournal journal;
+        bool journalling = false;  // true while a public move is recording into the journal
+
+        void setCellState(std::uint32_t i, CellState state) {
+            Cell& cell = grid[i];
+
+            const int hiddenDelta = (state != CellState::Revealed) - (cell.state() != CellState::Revealed);
+            const int flaggedDelta = (state == CellState::Flagged) - (cell.state() == CellState::Flagged);
+            if (hiddenDelta != 0 || flaggedDelta != 0) {
+                const std::uint8_t delta = static_cast<std::uint8_t>(hiddenDelta * 16 + flaggedDelta);
+                forEachNeighbour(i, [&](std::uint32_t n) { neighbourCounts[n] += delta; });
+            }
+
+            switch (cell.state()) {
+            case CellState::Revealed:   if (!cell.hasMine()) --revealedSafeCount; break;
+            case CellState::Flagged:    --flagCount; break;
+            case CellState::Questioned: --questionCount; break;
+            default: break;
+            }
+            switch (state) {
+            case CellState::Revealed:   if (!cell.hasMine()) ++revealedSafeCount; break;
+            case CellState::Flagged:    ++flagCount; break;
+            case CellState::Questioned: ++questionCount; break;
+            default: break;
+            }
+
+            if (journalling)
+                journal.record(i, cell.state(), state);
+            cell.setState(state);
+            if (changeSink)
+                changeSink->push_back({ std::uint64_t(i / Stride - 1) * W + (i % Stride - 1), state });
+        }
+
+        bool revealCell(std::uint32_t i) {
+            const Cell& cell = grid[i];
+            if (cell.state() == CellState::Revealed || cell.state() == CellState::Flagged) return true;
+
+            if (cell.hasMine()) {
+                setCellState(i, CellState::Revealed);
+                gameOver = true;
+                return false;
+            }
+
+            floodFillReveal(i);
+            return true;
+        }
+
+        void floodFillReveal(std::uint32_t i) {
+            const Cell& cell = grid[i];
+            if (cell.state() != CellState::Hidden) return;
+
+            setCellState(i, CellState::Revealed);
+            if (cell.adjacentMines() != 0 || cell.hasMine()) return;
+
+            // Reveal on push, push only zero cells: at most W * H entries
+            std::size_t top = 0;
+            fillStack[top++] = i;
+            while (top != 0) {
+                const std::uint32_t current = fillStack[--top];
+                forEachNeighbour(current, [&](std::uint32_t n) {
+                    const Cell& neighbour = grid[n];
+                    if (neighbour.state() != CellState::Hidden) return;
+
+                    setCellState(n, CellState::Revealed);
+                    if (neighbour.adjacentMines() == 0 && !neighbour.hasMine())
+                        fillStack[top++] = n;
+                });
+            }
+        }
+
+        // Fills candidates with the cells of rows [firstRow, lastRow) open
+        // to mines; returns how many there are
+        std::size_t collectCandidates(unsigned int firstRow, unsigned int lastRow) {
+            std::size_t candidateCount = 0;
+            for (unsigned int y = firstRow; y < lastRow; ++y) {
+                for (unsigned int x = 0; x < W; ++x) {
+                    const std::uint32_t i = index(x, y);
+                    if (!stencil.test(i))
+                        candidates[candidateCount++] = i;
+                }
+            }
+            return candidateCount;
+        }
+
+        // Puts mines on count of the first candidateCount candidates
+        void drawMines(std::size_t candidateCount, std::uint64_t count, Philox4x32& generator) {
+            for (std::uint64_t k = 0; k < count; ++k) {
+                std::swap(candidates[k], candidates[k + generator.below(candidateCount - k)]);
+                grid[candidates[k]].setMine(true);
+            }
+        }
+
+        // Fills in adjacentMines for every cell
+        void computeAdjacency() {
+            for (unsigned int y = 0; y < H; ++y) {
+                for (unsigned int x = 0; x < W; ++x) {
+                    const std::uint32_t i = index(x, y);
+                    unsigned int count = 0;
+                    forEachNeighbour(i, [&](std::uint32_t n) { count += grid[n].hasMine(); });
+                    grid[i].setAdjacentMines(count);
+                }
+            }
+        }
+
+        void placeMines(unsigned int safeX, unsigned int safeY) {
+            firstClickPos = { safeX, safeY };
+
+            // 1. Safe zone: breadth-first from the first click, as in Game
+            std::array<std::uint32_t, SafeZoneSize> safeZone{};
+            std::size_t zoneSize = 0;
+            stencil.reset();
+            safeZone[zoneSize++] = index(safeX, safeY);
+            stencil.set(safeZone[0]);
+            for (std::size_t head = 0; head < zoneSize && zoneSize < SafeZoneSize; ++head) {
+                for (std::size_t k = 0; k < Topology::Count; ++k) {
+                    const std::uint32_t n = neighbour(safeZone[head], k);
+                    if (!isInterior(n) || stencil.test(n)) continue;
+
+                    stencil.set(n);
+                    safeZone[zoneSize++] = n;
+                    if (zoneSize == SafeZoneSize) break;
+                }
+            }
+
+            // 2. No mines around the safe zone either
+            for (std::size_t k = 0; k < zoneSize; ++k)
+                forEachNeighbour(safeZone[k], [&](std::uint32_t n) { stencil.set(n); });
+
+            // 3. Partial Fisher-Yates over the allowed cells. Boards taller
+            //    than one band share the mines out between bands as Game does.
+            const std::uint64_t requested = static_cast<std::uint64_t>(static_cast<double>(W) * H * mineDensity);
+            const std::uint64_t boardKey = rng.next();
+            constexpr std::size_t Bands = Generation::bandCount(H);
+            if constexpr (Bands == 1) {
+                const std::size_t candidateCount = collectCandidates(0, H);
+                mineCount = std::min<std::uint64_t>(requested, candidateCount);
+                Philox4x32 generator = Generation::bandGenerator(boardKey, 0);
+                drawMines(candidateCount, mineCount, generator);
+            }
+            else {
+                std::array<std::uint64_t, Bands> allowed{}, quotas{};
+                for (unsigned int y = 0; y < H; ++y) {
+                    for (unsigned int x = 0; x < W; ++x)
+                        allowed[y / Generation::BandRows] += !stencil.test(index(x, y));
+                }
+
+                std::uint64_t allowedTotal = 0;
+                for (std::uint64_t count : allowed)
+                    allowedTotal += count;
+                mineCount = std::min<std::uint64_t>(requested, allowedTotal);
+                Generation::bandQuotas(allowed.data(), quotas.data(), Bands, mineCount);
+
+                for (std::size_t band = 0; band < Bands; ++band) {
+                    const unsigned int firstRow = static_cast<unsigned int>(band * Generation::BandRows);
+                    Philox4x32 generator = Generation::bandGenerator(boardKey, band);
+                    drawMines(collectCandidates(firstRow, std::min(H, firstRow + Generation::BandRows)), quotas[band], generator);
+                }
+            }
+
+            // 4. Adjacency counts
+            computeAdjacency();
+
+            // 5. Open the safe zone
+            for (std::size_t k = 0; k < zoneSize; ++k)
+                floodFillReveal(safeZone[k]);
+
+            isInitialized = true;
+        }
+
+        SnapshotHeader makeSnapshotHeader() const {
+            SnapshotHeader header = {};
+            std::memcpy(header.magic, SnapshotHeader::Magic, sizeof(header.magic));
+            header.version = SnapshotHeader::CurrentVersion;
+            header.width = W;
+            header.height = H;
+            header.firstClickX = firstClickPos.first;
+            header.firstClickY = firstClickPos.second;
+            header.seed = seed;
+            header.mineCount = mineCount;
+            header.revealedSafeCount = revealedSafeCount;
+            header.flagCount = flagCount;
+            header.questionCount = questionCount;
+            header.flags = (isInitialized ? SnapshotHeader::MinesPlaced : 0) | (gameOver ? SnapshotHeader::GameOver : 0);
+            header.topology = static_cast<std::uint8_t>(Topology::Kind);
+            header.mineDensity = mineDensity;
+            header.payloadSize = 2 * BufferSize;
+            header.checksum = snapshotChecksum(reinterpret_cast<const std::uint8_t*>(grid.data()),
+                neighbourCounts.data(), BufferSize);
+            return header;
+        }
+    };
+}
@@ -0,0 +1,109 @@
+#pragma once
+#include "API.h"
+#include "GameLogic.h"
+#include "Random.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Minesweeper {
+
+    // Alternative Game backend that stores every cell property in its own
+    // bitplane (one bit per cell, 64 cells per word).
+    // Adjacency counts come from shifted plane adds into bit-sliced counters,
+    // and zero-region reveals run as repeated dilation masked by the zero plane.
+    // Given the same mine layout it behaves exactly like Game, and boards
+    // are generated like Game's, so the same seed and first click give the
+    // same board.
+    class EXPORT_API BitboardGame {
+    public:
+        // Initialize a new game with given size. Without a seed one is drawn
+        // from std::random_device.
+        void initialize(unsigned int size);
+        void initialize(unsigned int width, unsigned int height);
+        void initialize(unsigned int size, Seed seed);
+        void initialize(unsigned int width, unsigned int height, Seed seed);
+
+        // Initialize with a fixed mine layout instead of first-click generation
+        void initializeWithMines(unsigned int width, unsigned int height,
+            const std::vector<std::pair<unsigned int, unsigned int>>& mines);
+
+        // Reveal the cell at (x, y); returns false if a mine was revealed
+        bool reveal(unsigned int x, unsigned int y);
+
+        // Toggle flag state on the cell at (x, y)
+        void toggleFlag(unsigned int x, unsigned int y);
+
+        // Check for win/lose condition (all non-mine cells revealed)
+        bool checkWin() const;
+        bool isGameOver() const;
+        bool hasEnded() const;
+
+        // Seed of the current board, for reproducing it later
+        std::uint64_t getSeed() const;
+
+        // Fraction of cells that get a mine on the next generated board
+        void setMineDensity(double density);
+        double getMineDensity() const;
+        std::uint64_t getMineCount() const;
+
+        // Mines left to flag (mine count minus placed flags; may go negative)
+        std::int64_t remainingMines() const;
+
+        // Accessors
+        unsigned int getWidth() const;
+        unsigned int getHeight() const;
+
+        // Cell at (x, y) in the same packed format Game uses
+        Cell cellAt(unsigned int x, unsigned int y) const;
+
+        // Bytes used by the game object and its bitplanes
+        std::size_t memoryFootprint() const;
+
+    private:
+        using Plane = std::vector<std::uint64_t>;
+
+        // Each plane holds height rows of wordsPerRow words plus one zero
+        // padding row above and below, so vertical neighbours need no checks
+        Plane mines, revealed, flagged, questioned;
+        Plane counts[4];  // bit-sliced adjacent mine count, counts[0] is the LSB
+        Plane zero;       // safe cells with no adjacent mines
+        Plane fill;       // work plane reused by floodFillReveal
+        std::vector<std::uint64_t> rowStamp;  // last fill sweep that grew each row
+        std::uint64_t fillEpoch = 0;
+        std::vector<std::uint64_t> candidates;  // allowed mine positions (y * width + x), reused by placeMines
+
+        unsigned int width = 0, height = 0, safeParam = 2;
+        double mineDensity = 0.175;
+        Xoshiro256 rng;
+        std::uint64_t seed = 0;
+        std::size_t wordsPerRow = 0;
+        std::uint64_t lastWordMask = 0;  // valid bits of the last word in a row
+        std::uint64_t mineCount = 0;
+        std::uint64_t revealedSafeCount = 0, flagCount = 0;
+        bool isInitialized = false;
+        bool gameOver = false;
+
+        // Word index of column x in row y, and the bit within that word
+        std::size_t wordIndex(unsigned int x, unsigned int y) const {
+            return (static_cast<std::size_t>(y) + 1) * wordsPerRow + x / 64;
+        }
+        static std::uint64_t bitOf(unsigned int x) { return std::uint64_t(1) << (x % 64); }
+
+        bool test(const Plane& plane, unsigned int x, unsigned int y) const {
+            return (plane[wordIndex(x, y)] & bitOf(x)) != 0;
+        }
+
+        // Sizes and clears every plane and resets the counters
+        void resetBoard(unsigned int width, unsigned int height);
+
+        // Reveal (x, y) and, if it is a zero cell, the whole region around it
+        void floodFillReveal(unsigned int x, unsigned int y);
+
+        // Builds the count planes and the zero plane from the mine plane
+        void computeAdjacency();
+
+        // Place mines around a safe zone at the first click position
+        void placeMines(unsigned int safeX, unsigned int safeY);
+    };
+}
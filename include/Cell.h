@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Minesweeper {
+
+    // Possible states of a cell
+    enum class CellState : std::uint8_t { Hidden, Revealed, Flagged, Questioned }; 
+
+    // Represents a single cell in the grid, packed into one byte:
+    // bits 0-3 adjacent mine count, bits 4-5 state, bit 6 mine, bit 7 set
+    // once the count is filled in (lazily counted boards leave it clear)
+    struct Cell {
+        static constexpr std::uint8_t CountMask = 0x0F;
+        static constexpr std::uint8_t StateShift = 4;
+        static constexpr std::uint8_t StateMask = 0x03 << StateShift;
+        static constexpr std::uint8_t MineBit = 0x40;
+        static constexpr std::uint8_t CountedBit = 0x80;
+
+        std::uint8_t bits = 0;
+
+        bool hasMine() const { return (bits & MineBit) != 0; }
+        unsigned int adjacentMines() const { return bits & CountMask; }
+        bool isCounted() const { return (bits & CountedBit) != 0; }
+        CellState state() const { return static_cast<CellState>((bits & StateMask) >> StateShift); }
+
+        void setMine(bool mine) {
+            bits = mine ? (bits | MineBit) : (bits & ~MineBit);
+        }
+        void setAdjacentMines(unsigned int count) {
+            bits = static_cast<std::uint8_t>((bits & ~CountMask) | (count & CountMask) | CountedBit);
+        }
+        void setState(CellState state) {
+            bits = static_cast<std::uint8_t>((bits & ~StateMask) | (static_cast<std::uint8_t>(state) << StateShift));
+        }
+    };
+    static_assert(sizeof(Cell) == 1, "Cell must stay packed into a single byte");
+}
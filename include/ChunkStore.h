@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Minesweeper {
+
+    // On-disk home for chunks paged out of memory. Every chunk is PackBits
+    // compressed (runs of equal bytes, which revealed and untouched areas are
+    // full of) and kept in one store file; an in-memory index maps chunk keys
+    // to their extent. A rewrite reuses the old extent when it still fits and
+    // appends otherwise.
+    class ChunkStore {
+    public:
+        // Create (or truncate) the store file at path
+        void open(const std::string& path);
+        void close();
+        bool isOpen() const;
+
+        // Drop every stored chunk, truncating the file
+        void clear();
+
+        // Compress and store size bytes under key, replacing any older copy
+        void write(std::uint64_t key, const std::uint8_t* data, std::size_t size);
+
+        // Load the chunk stored under key into data (size bytes); false if
+        // there is none. Throws std::runtime_error on a damaged record.
+        bool read(std::uint64_t key, std::uint8_t* data, std::size_t size);
+
+        bool contains(std::uint64_t key) const;
+        std::size_t storedCount() const;
+
+        // Bytes used by the index and the compression buffer
+        std::size_t memoryFootprint() const;
+
+    private:
+        struct Extent {
+            std::uint64_t offset;
+            std::uint32_t size;      // compressed bytes in use
+            std::uint32_t capacity;  // bytes reserved in the file
+        };
+
+        std::string path;
+        std::fstream file;
+        std::unordered_map<std::uint64_t, Extent> index;
+        std::uint64_t fileEnd = 0;
+        std::vector<std::uint8_t> buffer;  // compressed record, reused between calls
+    };
+}
@@ -0,0 +1,152 @@
+#pragma once
+#include "API.h"
+#include "Cell.h"
+#include "ChunkStore.h"
+#include "Random.h"
+
+#include <array>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Minesweeper {
+
+    // Unbounded board for endless mode. Cells live in 64x64 chunks kept in a
+    // hash map and created on first touch, so memory grows with the explored
+    // area. Whether a cell holds a mine is a pure hash of (seed, chunk
+    // coordinates, cell), so chunks come out the same in any creation order
+    // and a chunk's edge counts need no neighbouring chunk to exist.
+    // Coordinates may be negative; chunk coordinates must fit in 32 bits.
+    // With a chunk store set, resident chunks are capped by a memory budget:
+    // the least recently used ones are paged out (written back only if
+    // modified) and paged in again when touched.
+    class EXPORT_API EndlessGame {
+    public:
+        static constexpr int ChunkBits = 6;
+        static constexpr std::int64_t ChunkSize = std::int64_t(1) << ChunkBits;
+        static constexpr std::size_t ChunkCells = ChunkSize * ChunkSize;
+
+        // Cells one reveal may open; zero regions on sparse boards can be
+        // unbounded, so a flood fill stops here and keeps its frontier for
+        // continueReveal and later reveals
+        static constexpr std::uint64_t RevealLimit = std::uint64_t(1) << 20;
+
+        static constexpr std::size_t MinResidentChunks = 4;
+
+        // Start a new endless board. Without a seed one is drawn from
+        // std::random_device. Mines appear with the first reveal, which is
+        // always a zero cell.
+        void initialize();
+        void initialize(Seed seed);
+
+        // Chance of a mine in each cell outside the first-click area; takes
+        // effect on the next initialize
+        void setMineDensity(double density);
+        double getMineDensity() const;
+
+        // Reveal the cell at (x, y), opening at most RevealLimit cells;
+        // returns false if a mine was revealed
+        bool reveal(std::int64_t x, std::int64_t y);
+
+        // Reveal in slices, as in Game: beginReveal opens at most about
+        // budget cells, and each continueReveal about budget more. Zero
+        // cells whose neighbours are not opened yet are never dropped: a
+        // later reveal carries on from them too, so no region is left with
+        // a revealed zero cell next to a hidden one for good.
+        bool beginReveal(std::int64_t x, std::int64_t y, std::uint64_t budget);
+        void continueReveal(std::uint64_t budget);
+        bool isRevealPending() const;
+
+        // Page chunks to a store file at path once the resident chunks would
+        // exceed memoryBudget bytes (at least MinResidentChunks are kept).
+        // Set it before the first reveal; initialize empties the store.
+        void setChunkStore(const std::string& path, std::size_t memoryBudget);
+
+        // Write every modified resident chunk to the store
+        void flushChunks();
+
+        // Toggle flag state on the cell at (x, y); ignored before the first reveal
+        void toggleFlag(std::int64_t x, std::int64_t y);
+
+        bool isGameOver() const;
+        bool hasStarted() const;
+        std::uint64_t getSeed() const;
+
+        // Cells revealed and flags placed so far
+        std::uint64_t revealedCount() const;
+        std::uint64_t flagCount() const;
+
+        // Cell at (x, y) in the same packed format Game uses; cells of
+        // chunks not created yet read as hidden, paged-out chunks are paged in
+        Cell cellAt(std::int64_t x, std::int64_t y);
+
+        // Chunks in memory, and chunks with a copy in the store
+        std::size_t chunkCount() const;
+        std::size_t storedChunkCount() const;
+
+        // Bytes used by the game object and its chunks
+        std::size_t memoryFootprint() const;
+
+    private:
+        struct Chunk {
+            std::array<Cell, ChunkCells> cells;
+            std::list<std::uint64_t>::iterator lruPos;
+            bool dirty = false;  // changed since generated or last written
+        };
+
+        std::unordered_map<std::uint64_t, Chunk> chunks;  // resident chunks
+        std::list<std::uint64_t> lru;                     // resident keys, most recent first
+        ChunkStore store;
+        std::size_t maxResident = 0;                      // 0: no paging
+        std::uint64_t seed = 0;
+        double mineDensity = 0.175;
+        std::uint64_t mineThreshold = 0;  // cell hash below this holds a mine
+        std::int64_t startX = 0, startY = 0;
+        bool started = false;
+        bool gameOver = false;
+        std::uint64_t revealed = 0, flags = 0;
+        std::vector<std::pair<std::int64_t, std::int64_t>> fillStack;  // zero cells whose neighbours are still to open
+
+        // Last chunk looked up; flood fills mostly stay within one chunk
+        std::uint64_t cachedKey = 0;
+        Chunk* cachedChunk = nullptr;
+
+        static std::uint64_t chunkKey(std::int64_t cx, std::int64_t cy);
+        static std::int64_t chunkX(std::uint64_t key) { return static_cast<std::int32_t>(key >> 32); }
+        static std::int64_t chunkY(std::uint64_t key) { return static_cast<std::int32_t>(key & 0xFFFFFFFFu); }
+        static std::size_t localIndex(std::int64_t x, std::int64_t y) {
+            return static_cast<std::size_t>(((y & (ChunkSize - 1)) << ChunkBits) | (x & (ChunkSize - 1)));
+        }
+
+        // Mine layout as a pure function of the coordinates
+        bool mineAt(std::int64_t x, std::int64_t y) const;
+
+        // Cell at (x, y), paging in or creating its chunk first if needed.
+        // The reference is valid until the next lookup, which may evict.
+        Cell& cell(std::int64_t x, std::int64_t y);
+
+        // Make key resident (paging in or generating it) unless create is
+        // false and it was never created; may evict the coldest chunk
+        Chunk* residentChunk(std::uint64_t key, bool create);
+
+        // Change a cell returned by the latest cell() call and mark its chunk dirty
+        void setCellState(Cell& c, CellState state);
+
+        // Page out least recently used chunks down to maxResident
+        void evict();
+
+        // Place mines and adjacency counts for the chunk (cx, cy)
+        void generateChunk(Chunk& chunk, std::int64_t cx, std::int64_t cy) const;
+
+        // Reveal the cell and, if it has no adjacent mines, up to budget
+        // cells of its zero region
+        void floodFillReveal(std::int64_t x, std::int64_t y, std::uint64_t budget);
+
+        // Opens neighbours of the zero cells in fillStack until it is empty
+        // or budget cells have been opened
+        void continueFill(std::uint64_t budget);
+    };
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include "API.h"
+#include "Cell.h"
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace Minesweeper {
+
+    // Undo/redo history of Game and BasicGame moves. A move stores only the
+    // cells it changed, sorted by buffer index and run-length encoded, so a
+    // flood reveal costs one run per row segment rather than one entry per
+    // cell.
+    // At most depth moves are kept; older ones are dropped.
+    class EXPORT_API MoveJournal {
+    public:
+        // Consecutive cells that all went from one state to another
+        struct Run {
+            std::uint64_t start;
+            std::uint32_t length;
+            CellState before;
+            CellState after;
+        };
+
+        struct Move {
+            std::vector<Run> runs;
+            bool gameOverBefore = false;
+            bool gameOverAfter = false;
+        };
+
+        // Maximum number of moves kept; 0 turns the journal off
+        void setDepth(std::size_t depth);
+        std::size_t getDepth() const;
+
+        void clear();
+
+        // Records a cell change of the move in progress
+        void record(std::uint64_t index, CellState before, CellState after) {
+            if (depth != 0)
+                pending.push_back({ index, before, after });
+        }
+
+        // Closes the move in progress. A move that changed cells becomes the
+        // newest undo step and discards everything that could be redone.
+        void commit(bool gameOverBefore, bool gameOverAfter);
+
+        // Moves the newest step from the undo to the redo stack (or back) and
+        // returns it, or nullptr if there is nothing to step over
+        const Move* undo();
+        const Move* redo();
+
+        bool canUndo() const;
+        bool canRedo() const;
+
+        std::size_t memoryFootprint() const;
+
+    private:
+        struct Change {
+            std::uint64_t index;
+            CellState before;
+            CellState after;
+        };
+
+        std::vector<Change> pending;
+        std::deque<Move> done;
+        std::vector<Move> undone;
+        std::size_t depth = 256;
+    };
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include "API.h"
+
+#include <cstdint>
+#include <string>
+
+namespace Minesweeper {
+
+    // Read-write shared mapping of a whole file. Writes through data() reach
+    // the file when the OS pages them out, at flush() or at close().
+    class EXPORT_API MappedFile {
+    public:
+        MappedFile() = default;
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        ~MappedFile();
+
+        // Map an existing file; throws std::runtime_error on failure
+        void open(const std::string& path);
+
+        // Create (or truncate) a zero-filled file of the given size and map it
+        void create(const std::string& path, std::uint64_t size);
+
+        // Write dirty pages back to disk; false on failure
+        bool flush();
+
+        void close();
+
+        bool isOpen() const { return base != nullptr; }
+        void* data() const { return base; }
+        std::uint64_t size() const { return length; }
+
+    private:
+        void map(const std::string& path, std::uint64_t size, bool create);
+
+        void* base = nullptr;
+        std::uint64_t length = 0;
+#ifdef _WIN32
+        void* file = nullptr;     // HANDLE of the open file
+        void* mapping = nullptr;  // HANDLE of the file mapping object
+#else
+        int fd = -1;
+#endif
+    };
+}
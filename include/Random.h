@@ -0,0 +1,146 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Minesweeper {
+
+    // Seed for board generation. A separate type so that initialize(size, seed)
+    // can't be confused with initialize(width, height).
+    struct Seed {
+        std::uint64_t value = 0;
+    };
+
+    // Source of random numbers used to generate boards.
+    // Implementations must give the same sequence for the same seed on every
+    // platform, so a seed is enough to reproduce a board.
+    class RandomGenerator {
+    public:
+        using result_type = std::uint64_t;
+
+        virtual ~RandomGenerator() = default;
+
+        virtual void seed(std::uint64_t value) = 0;
+        virtual std::uint64_t next() = 0;
+
+        // Uniform integer in [0, bound), bound > 0. Uses rejection instead of
+        // std::uniform_int_distribution, whose output differs between
+        // standard libraries.
+        std::uint64_t below(std::uint64_t bound) {
+            const std::uint64_t threshold = (0 - bound) % bound;
+            for (;;) {
+                const std::uint64_t r = next();
+                if (r >= threshold)
+                    return r % bound;
+            }
+        }
+
+        // UniformRandomBitGenerator interface, for use with <random> and <algorithm>
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return ~result_type(0); }
+        result_type operator()() { return next(); }
+    };
+
+    // SplitMix64 step; expands a single seed into well-mixed state words
+    inline std::uint64_t splitMix64(std::uint64_t& state) {
+        std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // xoshiro256** by Blackman and Vigna: 32 bytes of state, fast and
+    // statistically strong. Default generator for Game.
+    class Xoshiro256 : public RandomGenerator {
+    public:
+        explicit Xoshiro256(std::uint64_t value = 0) { seed(value); }
+
+        void seed(std::uint64_t value) override {
+            for (std::uint64_t& word : s)
+                word = splitMix64(value);
+        }
+
+        std::uint64_t next() override {
+            const std::uint64_t result = rotl(s[1] * 5, 7) * 9;
+            const std::uint64_t t = s[1] << 17;
+
+            s[2] ^= s[0];
+            s[3] ^= s[1];
+            s[1] ^= s[2];
+            s[0] ^= s[3];
+            s[2] ^= t;
+            s[3] = rotl(s[3], 45);
+
+            return result;
+        }
+
+    private:
+        static std::uint64_t rotl(std::uint64_t x, int k) {
+            return (x << k) | (x >> (64 - k));
+        }
+
+        std::uint64_t s[4];
+    };
+
+    // Philox4x32-10 (Salmon et al., "Parallel Random Numbers: As Easy as
+    // 1, 2, 3"), a counter-based generator: block n of stream s is a pure
+    // function of (key, s, n), ten rounds of multiplies and xors, so any
+    // stream can be started, or any point of it reached, without producing
+    // what comes before. Boards draw each band from a stream of their own.
+    class Philox4x32 final : public RandomGenerator {
+    public:
+        explicit Philox4x32(std::uint64_t key = 0, std::uint64_t stream = 0) : key(key), stream(stream) {}
+
+        // Keys the generator and goes back to the start of stream 0
+        void seed(std::uint64_t value) override {
+            key = value;
+            seek(0, 0);
+        }
+
+        // Moves to 64-bit word position of stream
+        void seek(std::uint64_t streamIndex, std::uint64_t position) {
+            stream = streamIndex;
+            word = position;
+            if (word & 1)
+                block(key, stream, word >> 1, buffer);
+        }
+
+        std::uint64_t next() override {
+            if ((word & 1) == 0)
+                block(key, stream, word >> 1, buffer);
+            return buffer[word++ & 1];
+        }
+
+        // The two 64-bit words of block counter of stream
+        static void block(std::uint64_t key, std::uint64_t stream, std::uint64_t counter, std::uint64_t out[2]) {
+            std::uint32_t c[4] = {
+                static_cast<std::uint32_t>(counter), static_cast<std::uint32_t>(counter >> 32),
+                static_cast<std::uint32_t>(stream), static_cast<std::uint32_t>(stream >> 32)
+            };
+            std::uint32_t k0 = static_cast<std::uint32_t>(key), k1 = static_cast<std::uint32_t>(key >> 32);
+
+            for (int round = 0; round < 10; ++round) {
+                if (round > 0) {
+                    k0 += 0x9E3779B9u;
+                    k1 += 0xBB67AE85u;
+                }
+                const std::uint64_t p0 = std::uint64_t(0xD2511F53u) * c[0];
+                const std::uint64_t p1 = std::uint64_t(0xCD9E8D57u) * c[2];
+                const std::uint32_t next0 = static_cast<std::uint32_t>(p1 >> 32) ^ c[1] ^ k0;
+                const std::uint32_t next2 = static_cast<std::uint32_t>(p0 >> 32) ^ c[3] ^ k1;
+                c[0] = next0;
+                c[1] = static_cast<std::uint32_t>(p1);
+                c[2] = next2;
+                c[3] = static_cast<std::uint32_t>(p0);
+            }
+
+            out[0] = c[0] | (static_cast<std::uint64_t>(c[1]) << 32);
+            out[1] = c[2] | (static_cast<std::uint64_t>(c[3]) << 32);
+        }
+
+    private:
+        std::uint64_t key;
+        std::uint64_t stream;
+        std::uint64_t word = 0;  // position in the stream, in 64-bit words
+        std::uint64_t buffer[2] = {};
+    };
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include "API.h"
+#include "Topology.h"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+namespace Minesweeper {
+
+    // Snapshots are raw copies of the in-memory buffers
+    static_assert(std::endian::native == std::endian::little, "Snapshot format is little-endian");
+
+    // Fixed-size header at the start of every snapshot, followed by the
+    // payload: the cell buffer (sentinel ring included) and then the
+    // neighbour counter buffer, both (width + 2) * (height + 2) bytes.
+    // Shared by Game and BasicGame, so either can write a board the other reads.
+    struct SnapshotHeader {
+        static constexpr char Magic[4] = { 'M', 'S', 'W', 'P' };
+        static constexpr std::uint32_t CurrentVersion = 1;
+
+        // Bits of flags
+        static constexpr std::uint8_t MinesPlaced = 1;
+        static constexpr std::uint8_t GameOver = 2;
+        static constexpr std::uint8_t Mapped = 4;  // live mapped board: payload changes in place, no checksum
+
+        char magic[4];
+        std::uint32_t version;
+        std::uint32_t width, height;
+        std::uint32_t firstClickX, firstClickY;
+        std::uint64_t seed;
+        std::uint64_t mineCount;
+        std::uint64_t revealedSafeCount, flagCount, questionCount;
+        std::uint8_t flags;
+        std::uint8_t topology;  // TopologyKind; Square in files from before it existed
+        std::uint8_t reserved[6];
+        double mineDensity;
+        std::uint64_t payloadSize;
+        std::uint64_t checksum;  // of the payload
+
+        // Checks everything but the checksum against a reader of the given
+        // topology; returns the size of one buffer
+        std::uint64_t validate(TopologyKind expected) const {
+            if (std::memcmp(magic, Magic, sizeof(magic)) != 0)
+                throw std::runtime_error("Not a Minesweeper snapshot.");
+            if (version != CurrentVersion)
+                throw std::runtime_error("Unsupported snapshot version.");
+            if (topology != static_cast<std::uint8_t>(expected))
+                throw std::runtime_error("Snapshot uses a different board topology.");
+
+            const std::uint64_t size = (static_cast<std::uint64_t>(width) + 2) * (static_cast<std::uint64_t>(height) + 2);
+            if (payloadSize != 2 * size)
+                throw std::runtime_error("Snapshot payload size does not match the board.");
+            return size;
+        }
+    };
+    static_assert(sizeof(SnapshotHeader) == 96, "Snapshot header layout changed");
+
+    // Checksum of a snapshot payload: the cell buffer, then the counter buffer
+    EXPORT_API std::uint64_t snapshotChecksum(const std::uint8_t* cells, const std::uint8_t* counts, std::size_t bufferSize);
+}
@@ -0,0 +1,148 @@
+#pragma once
+#include "API.h"
+#include "Cell.h"
+#include "GameLogic.h"
+#include "Random.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Minesweeper {
+
+    // Game backend for huge, low-density boards. Mines are kept as a sorted
+    // list of row-major positions, with the offset at which each row's
+    // mines start. Cell states are kept in bitmaps of 64x64-cell tiles: a
+    // tile is stored only once one of its cells is set, and it gives up its
+    // words again once all of them are. Adjacency counts are derived from
+    // the mine list when needed. Memory follows the mine count and the area
+    // played, not the board size.
+    // Boards are generated exactly like Game's, and moves report their
+    // changes the same way, so the same seed and clicks play the same game.
+    // Game hands out its dense cell buffer (getGrid, snapshots, mapped
+    // files), so sparse storage is a class of its own rather than a mode of
+    // Game; isPreferred tells callers which of the two a board should use.
+    class EXPORT_API SparseGame {
+    public:
+        // Boards of at least SparseCells cells with a density of at most
+        // SparseDensity: Game spends two bytes on every cell there, this
+        // class about eight per mine plus a bit per played cell
+        static constexpr std::uint64_t SparseCells = std::uint64_t(1) << 24;
+        static constexpr double SparseDensity = 0.02;
+        static bool isPreferred(unsigned int width, unsigned int height, double density);
+
+        // Initialize a new game with given size. Without a seed one is drawn
+        // from std::random_device.
+        void initialize(unsigned int width, unsigned int height);
+        void initialize(unsigned int width, unsigned int height, Seed seed);
+
+        // Initialize with a fixed mine layout instead of first-click generation
+        void initializeWithMines(unsigned int width, unsigned int height,
+            const std::vector<std::pair<unsigned int, unsigned int>>& mines);
+
+        // Moves, as in Game: reveal and chord return false if a mine was
+        // revealed, and changes (if given) receives every changed cell
+        bool reveal(unsigned int x, unsigned int y, ChangeSet* changes = nullptr);
+        void toggleFlag(unsigned int x, unsigned int y, ChangeSet* changes = nullptr);
+        bool chord(unsigned int x, unsigned int y, ChangeSet* changes = nullptr);
+
+        // Check for win/lose condition (all non-mine cells revealed)
+        bool checkWin() const;
+        bool isGameOver() const;
+        bool hasEnded() const;
+
+        // Seed of the current board, for reproducing it later
+        std::uint64_t getSeed() const;
+
+        // Fraction of cells that get a mine on the next generated board
+        void setMineDensity(double density);
+        double getMineDensity() const;
+        std::uint64_t getMineCount() const;
+
+        // Mines left to flag (mine count minus placed flags; may go negative)
+        std::int64_t remainingMines() const;
+
+        // Adjacent mines of the cell at (x, y), counted from the mine list
+        unsigned int getAdjacentMines(unsigned int x, unsigned int y) const;
+
+        // Accessors
+        unsigned int getWidth() const;
+        unsigned int getHeight() const;
+
+        // Cell at (x, y) in the same packed format Game uses
+        Cell cellAt(unsigned int x, unsigned int y) const;
+
+        // Bytes used by the game object, its mine list and its bitmaps
+        std::size_t memoryFootprint() const;
+
+    private:
+        // Set of cells, stored per 64x64 tile with one word per tile row
+        class TileBitmap {
+        public:
+            void reset(unsigned int width, unsigned int height);
+            bool test(unsigned int x, unsigned int y) const;
+            void set(unsigned int x, unsigned int y);
+            void clear(unsigned int x, unsigned int y);
+            std::size_t memoryFootprint() const;
+
+        private:
+            struct Tile {
+                std::uint32_t count = 0;           // cells set
+                std::vector<std::uint64_t> rows;   // empty once every cell of the tile is set
+            };
+            std::unordered_map<std::uint64_t, Tile> tiles;
+            unsigned int width = 0, height = 0;
+            std::uint64_t tilesPerRow = 0;
+
+            std::uint64_t tileKey(unsigned int x, unsigned int y) const {
+                return static_cast<std::uint64_t>(y >> 6) * tilesPerRow + (x >> 6);
+            }
+
+            // Cells of the tile holding (x, y) that lie on the board
+            std::uint32_t tileCells(unsigned int x, unsigned int y) const;
+        };
+
+        std::vector<std::uint64_t> mines;     // row-major positions (y * width + x), ascending
+        std::vector<std::uint64_t> rowStart;  // mines of row y are mines[rowStart[y], rowStart[y + 1])
+        TileBitmap revealed, flagged, questioned;
+        unsigned int width = 0, height = 0, safeParam = 2;
+        double mineDensity = 0.175;
+        Xoshiro256 rng;
+        std::uint64_t seed = 0;
+        std::uint64_t mineCount = 0;
+        std::uint64_t revealedSafeCount = 0, flagCount = 0;
+        bool isInitialized = false;
+        bool gameOver = false;
+        ChangeSet* changeSink = nullptr;      // change set of the move in progress
+        std::vector<std::uint64_t> fillStack; // packed (y << 32 | x), reused by floodFillReveal
+
+        struct MoveScope;
+
+        // Empties the board and sizes the bitmaps and row index
+        void resetBoard(unsigned int width, unsigned int height);
+
+        // Rebuilds rowStart from the sorted mine list
+        void indexRows();
+
+        bool hasMine(unsigned int x, unsigned int y) const;
+        unsigned int countAdjacent(unsigned int x, unsigned int y) const;
+        CellState stateAt(unsigned int x, unsigned int y) const;
+
+        // Moves the cell between bitmaps, keeps the counters in step and
+        // reports the change
+        void setCellState(unsigned int x, unsigned int y, CellState state);
+
+        // Reveal logic shared by reveal and chord, for an initialized board
+        bool revealCell(unsigned int x, unsigned int y);
+
+        // Reveal the cell and, if it has no adjacent mines, its whole zero region
+        void floodFillReveal(unsigned int x, unsigned int y);
+
+        // Place mines around a safe zone at the first click position
+        void placeMines(unsigned int safeX, unsigned int safeY);
+
+        // Boards with at least this many cells draw their bands on several threads
+        static constexpr std::uint64_t ParallelCells = std::uint64_t(1) << 18;
+    };
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Minesweeper {
+
+    enum class TopologyKind : std::uint8_t { Square, Torus, Hex, Knight };
+
+    // Neighbour policies for BasicGame. neighbour<W, H>(i, k) is the buffer
+    // index of neighbour k (0 <= k < Count) of the board cell at buffer index
+    // i, for a W x H board stored with a one-cell sentinel ring (stride W + 2).
+    // Neighbours off the board map to a sentinel, so callers never check
+    // bounds. Every relation is symmetric, which the neighbour counters need.
+    // ShiftOddRows tells renderers to draw odd rows half a tile to the right.
+
+    // Classic eight surrounding cells, in Game's neighbour order
+    struct Square8 {
+        static constexpr TopologyKind Kind = TopologyKind::Square;
+        static constexpr std::size_t Count = 8;
+        static constexpr bool ShiftOddRows = false;
+
+        template <unsigned int W, unsigned int H>
+        static constexpr std::uint32_t neighbour(std::uint32_t i, std::size_t k) {
+            constexpr std::int32_t s = W + 2;
+            constexpr std::int32_t offsets[8] = { -s - 1, -s, -s + 1, -1, 1, s - 1, s, s + 1 };
+            return static_cast<std::uint32_t>(static_cast<std::int32_t>(i) + offsets[k]);
+        }
+    };
+
+    // Eight surrounding cells with edges wrapping around to the opposite side
+    struct Torus {
+        static constexpr TopologyKind Kind = TopologyKind::Torus;
+        static constexpr std::size_t Count = 8;
+        static constexpr bool ShiftOddRows = false;
+
+        template <unsigned int W, unsigned int H>
+        static constexpr std::uint32_t neighbour(std::uint32_t i, std::size_t k) {
+            static_assert(W >= 3 && H >= 3, "Torus neighbours are only distinct from 3x3 up");
+            constexpr std::uint32_t s = W + 2;
+            constexpr std::uint32_t dx[8] = { W - 1, 0, 1, W - 1, 1, W - 1, 0, 1 };
+            constexpr std::uint32_t dy[8] = { H - 1, H - 1, H - 1, 0, 0, 1, 1, 1 };
+            const std::uint32_t x = (i % s - 1 + dx[k]) % W;
+            const std::uint32_t y = (i / s - 1 + dy[k]) % H;
+            return (y + 1) * s + x + 1;
+        }
+    };
+
+    // Six neighbours of a hexagonal grid stored as rows, odd rows shifted
+    // half a cell right: the diagonal neighbours lean left on even rows and
+    // right on odd ones
+    struct Hex {
+        static constexpr TopologyKind Kind = TopologyKind::Hex;
+        static constexpr std::size_t Count = 6;
+        static constexpr bool ShiftOddRows = true;
+
+        template <unsigned int W, unsigned int H>
+        static constexpr std::uint32_t neighbour(std::uint32_t i, std::size_t k) {
+            constexpr std::int32_t s = W + 2;
+            constexpr std::int32_t offsets[6] = { -s - 1, -s, -1, 1, s - 1, s };
+            constexpr std::int32_t leans[6] = { 1, 1, 0, 0, 1, 1 };
+            const std::int32_t oddRow = static_cast<std::int32_t>((i / s - 1) & 1);
+            return static_cast<std::uint32_t>(static_cast<std::int32_t>(i) + offsets[k] + (leans[k] & oddRow));
+        }
+    };
+
+    // The eight cells a chess knight reaches; moves off the board land on
+    // the top-left sentinel
+    struct Knight {
+        static constexpr TopologyKind Kind = TopologyKind::Knight;
+        static constexpr std::size_t Count = 8;
+        static constexpr bool ShiftOddRows = false;
+
+        template <unsigned int W, unsigned int H>
+        static constexpr std::uint32_t neighbour(std::uint32_t i, std::size_t k) {
+            constexpr std::uint32_t s = W + 2;
+            constexpr std::int32_t dx[8] = { -1, 1, -2, 2, -2, 2, -1, 1 };
+            constexpr std::int32_t dy[8] = { -2, -2, -1, -1, 1, 1, 2, 2 };
+            const std::uint32_t x = i % s - 1 + dx[k];
+            const std::uint32_t y = i / s - 1 + dy[k];
+            return x < W && y < H ? (y + 1) * s + x + 1 : 0;
+        }
+    };
+
+    // Horizontal offset of row y, in tiles, for drawing and mouse hit-tests
+    template <typename Topology>
+    constexpr float rowShift(unsigned int y) {
+        return Topology::ShiftOddRows && (y & 1) ? 0.5f : 0.0f;
+    }
+}
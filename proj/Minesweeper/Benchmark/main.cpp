@@ -0,0 +1,189 @@
+#include "BatchSimulator.h"
+#include "GameLogic.h"
+#include "SparseGame.h"
+#include "TiledGame.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Compares TiledGame's cell layouts on one large board: generation (mine
+// placement, adjacency counts and the first reveal), a mass reveal that
+// floods nearly the whole board, and full-board scans through the cell
+// accessor in row and in column order. The simulate mode plays many games
+// with BatchSimulator's default player instead and reports throughput.
+// The board mode plays the first click of one board, on the backend
+// SparseGame::isPreferred picks for its size and density.
+// Usage: Benchmark [width [height [repeats]]]
+//        Benchmark simulate [games [width height]]
+//        Benchmark board width height [density]
+
+using namespace Minesweeper;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+    struct LayoutInfo {
+        CellLayout layout;
+        const char* name;
+    };
+
+    const LayoutInfo layouts[] = {
+        { CellLayout::RowMajor, "row-major" },
+        { CellLayout::Tiles8,   "8x8 tiles" },
+        { CellLayout::Tiles16,  "16x16 tiles" },
+        { CellLayout::ZOrder,   "Z-order" },
+    };
+
+    // Best of repeats runs of body, in milliseconds; setup is not timed
+    template <typename Setup, typename Body>
+    double bestOf(int repeats, Setup&& setup, Body&& body) {
+        double best = 0.0;
+        for (int r = 0; r < repeats; ++r) {
+            setup();
+            const Clock::time_point start = Clock::now();
+            body();
+            const double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            if (r == 0 || ms < best)
+                best = ms;
+        }
+        return best;
+    }
+
+    int simulate(int argc, char* argv[]) {
+        BatchConfig config;
+        if (argc > 2) config.games = std::strtoull(argv[2], nullptr, 10);
+        if (argc > 4) {
+            config.width = std::atoi(argv[3]);
+            config.height = std::atoi(argv[4]);
+        }
+        if (config.games == 0 || config.width == 0 || config.height == 0) {
+            std::cerr << "Usage: Benchmark simulate [games [width height]]\n";
+            return 1;
+        }
+
+        const BatchResult result = BatchSimulator().run(config);
+        std::cout << result.games << " games on " << config.width << " x " << config.height
+            << " with " << result.threads << " threads in " << result.seconds << " s\n"
+            << "won " << result.wins << ", lost " << result.losses << ", unfinished " << result.unfinished << '\n'
+            << std::fixed << std::setprecision(0) << result.gamesPerSecond() << " games/s, "
+            << result.gamesPerSecondPerCore() << " games/s per core\n";
+        return 0;
+    }
+
+    // First click on a fresh board: generation plus the opening it reveals
+    template <typename GameType>
+    void firstClick(GameType& game, const char* backend, unsigned int width, unsigned int height, double density) {
+        game.setMineDensity(density);
+        const Clock::time_point start = Clock::now();
+        game.initialize(width, height, Seed{ 1 });
+        game.reveal(width / 2, height / 2);
+        const double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        std::cout << width << " x " << height << " at density " << density << " on " << backend << ": "
+            << game.getMineCount() << " mines, " << std::fixed << std::setprecision(1) << ms << " ms, "
+            << game.memoryFootprint() / (1024.0 * 1024.0) << " MiB\n";
+    }
+
+    int board(int argc, char* argv[]) {
+        const unsigned int width = argc > 2 ? std::atoi(argv[2]) : 0;
+        const unsigned int height = argc > 3 ? std::atoi(argv[3]) : 0;
+        const double density = argc > 4 ? std::atof(argv[4]) : 0.175;
+        if (width == 0 || height == 0 || density < 0.0 || density > 1.0) {
+            std::cerr << "Usage: Benchmark board width height [density]\n";
+            return 1;
+        }
+
+        // Huge low-density boards keep their mines as a list, anything else
+        // the dense cell buffer
+        if (SparseGame::isPreferred(width, height, density)) {
+            SparseGame game;
+            firstClick(game, "SparseGame", width, height, density);
+        }
+        else {
+            Game game;
+            game.setDebugOutput(false);
+            firstClick(game, "Game", width, height, density);
+        }
+        return 0;
+    }
+
+    // Sum of every cell's bits, visiting rows (or columns) in turn; the
+    // result is printed so the scan can't be optimised away
+    std::uint64_t scan(const TiledGame& game, bool byColumns) {
+        const unsigned int w = game.getWidth(), h = game.getHeight();
+        std::uint64_t sum = 0;
+        if (byColumns) {
+            for (unsigned int x = 0; x < w; ++x)
+                for (unsigned int y = 0; y < h; ++y)
+                    sum += game.cellAt(x, y).bits;
+        }
+        else {
+            for (unsigned int y = 0; y < h; ++y)
+                for (unsigned int x = 0; x < w; ++x)
+                    sum += game.cellAt(x, y).bits;
+        }
+        return sum;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc > 1 && std::string(argv[1]) == "simulate")
+        return simulate(argc, argv);
+    if (argc > 1 && std::string(argv[1]) == "board")
+        return board(argc, argv);
+
+    const unsigned int width = argc > 1 ? std::atoi(argv[1]) : 4096;
+    const unsigned int height = argc > 2 ? std::atoi(argv[2]) : width;
+    const int repeats = argc > 3 ? std::atoi(argv[3]) : 3;
+    if (width == 0 || height == 0 || repeats <= 0) {
+        std::cerr << "Usage: Benchmark [width [height [repeats]]]\n";
+        return 1;
+    }
+
+    // Sparse fixed layout for the mass reveal, shared by every layout
+    std::vector<std::pair<unsigned int, unsigned int>> sparseMines;
+    std::mt19937_64 gen(1);
+    const std::uint64_t sparseCount = static_cast<std::uint64_t>(width) * height / 200;
+    for (std::uint64_t k = 0; k < sparseCount; ++k)
+        sparseMines.push_back({ static_cast<unsigned int>(gen() % width), static_cast<unsigned int>(gen() % height) });
+
+    std::cout << "Board " << width << " x " << height << ", best of " << repeats << " runs (ms)\n\n";
+    std::cout << std::left << std::setw(14) << "layout" << std::right
+        << std::setw(12) << "generate" << std::setw(12) << "mass reveal"
+        << std::setw(12) << "scan rows" << std::setw(12) << "scan cols"
+        << std::setw(22) << "checksum" << '\n';
+
+    for (const LayoutInfo& info : layouts) {
+        TiledGame game;
+
+        const double generate = bestOf(repeats,
+            [&] { game.initialize(width, height, Seed{ 1 }, info.layout); },
+            [&] { game.reveal(width / 2, height / 2); });
+
+        const double massReveal = bestOf(repeats,
+            [&] { game.initializeWithMines(width, height, sparseMines, info.layout); },
+            [&] {
+                for (unsigned int y = 0; y < height; y += 64)
+                    for (unsigned int x = 0; x < width; x += 64)
+                        if (!game.cellAt(x, y).hasMine())
+                            game.reveal(x, y);
+            });
+
+        std::uint64_t rowSum = 0, columnSum = 0;
+        const double scanRows = bestOf(repeats, [] {}, [&] { rowSum = scan(game, false); });
+        const double scanCols = bestOf(repeats, [] {}, [&] { columnSum = scan(game, true); });
+
+        std::cout << std::left << std::setw(14) << info.name << std::right << std::fixed << std::setprecision(1)
+            << std::setw(12) << generate << std::setw(12) << massReveal
+            << std::setw(12) << scanRows << std::setw(12) << scanCols
+            << std::setw(22) << rowSum + columnSum << '\n';
+    }
+
+    return 0;
+}
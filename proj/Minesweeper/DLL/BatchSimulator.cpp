@@ -0,0 +1,98 @@
+#include "BatchSimulator.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace Minesweeper {
+
+    BatchResult BatchSimulator::run(const BatchConfig& config) const {
+        return run(config, &BatchSimulator::simplePlayer);
+    }
+
+    BatchResult BatchSimulator::run(const BatchConfig& config, const Player& player) const {
+        if (!player)
+            throw std::invalid_argument("Batch simulation needs a player.");
+
+        std::size_t threads = config.threads ? std::min(config.threads, hardwareThreads()) : hardwareThreads();
+        threads = static_cast<std::size_t>(std::clamp<std::uint64_t>(config.games, 1, threads));
+
+        BatchResult total;
+        total.threads = threads;
+        std::mutex totalLock;
+        std::atomic<std::uint64_t> nextGame{ 0 };
+
+        const auto start = std::chrono::steady_clock::now();
+
+        parallelFor(threads, [&](std::size_t) {
+            Game game;
+            game.setDebugOutput(false);
+            game.setHistoryDepth(0);
+            game.setMineDensity(config.mineDensity);
+            Xoshiro256 playerRng;
+            BatchResult tally;
+
+            for (;;) {
+                const std::uint64_t k = nextGame.fetch_add(1, std::memory_order_relaxed);
+                if (k >= config.games) break;
+
+                game.initialize(config.width, config.height, Seed{ config.firstSeed + k });
+                playerRng.seed(~(config.firstSeed + k));  // apart from the board's stream
+                player(game, playerRng);
+
+                ++tally.games;
+                if (game.isGameOver()) ++tally.losses;
+                else if (game.checkWin()) ++tally.wins;
+                else ++tally.unfinished;
+            }
+
+            std::lock_guard<std::mutex> lock(totalLock);
+            total.games += tally.games;
+            total.wins += tally.wins;
+            total.losses += tally.losses;
+            total.unfinished += tally.unfinished;
+        });
+
+        total.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return total;
+    }
+
+    void BatchSimulator::simplePlayer(Game& game, RandomGenerator& rng) {
+        const GridView grid = game.getGrid();
+        const unsigned int width = grid.width(), height = grid.height();
+        ChangeSet changes;
+        std::vector<std::pair<unsigned int, unsigned int>> hidden;
+
+        game.reveal(width / 2, height / 2);
+        while (!game.hasEnded()) {
+            // Sure moves first: flags around saturated numbers, then chords
+            game.autoFlag(&changes);
+            bool progress = !changes.empty();
+            for (unsigned int y = 0; y < height && !game.hasEnded(); ++y) {
+                for (unsigned int x = 0; x < width && !game.hasEnded(); ++x) {
+                    const Cell cell = grid.at(x, y);
+                    if (cell.state() != CellState::Revealed || cell.adjacentMines() == 0) continue;
+                    game.chord(x, y, &changes);
+                    progress |= !changes.empty();
+                }
+            }
+            if (progress || game.hasEnded()) continue;
+
+            // Stuck: guess
+            hidden.clear();
+            for (unsigned int y = 0; y < height; ++y) {
+                for (unsigned int x = 0; x < width; ++x) {
+                    if (grid.at(x, y).state() == CellState::Hidden)
+                        hidden.push_back({ x, y });
+                }
+            }
+            if (hidden.empty()) return;
+            const auto [x, y] = hidden[rng.below(hidden.size())];
+            game.reveal(x, y);
+        }
+    }
+
+} // namespace Minesweeper
@@ -0,0 +1,48 @@
+#pragma once
+#include "API.h"
+#include "GameLogic.h"
+#include "Random.h"
+
+#include <cstdint>
+#include <functional>
+
+namespace Minesweeper {
+
+    // Plays one game that has just been initialized, through Game's public
+    // API, until it ends or the player gives up. rng is seeded per game, so
+    // a player that draws from it plays every game the same way each run.
+    using Player = std::function<void(Game& game, RandomGenerator& rng)>;
+
+    struct BatchConfig {
+        unsigned int width = 30, height = 16;
+        double mineDensity = 0.175;
+        std::uint64_t games = 10000;
+        std::uint64_t firstSeed = 1;  // game k is played on Seed{ firstSeed + k }
+        std::size_t threads = 0;      // 0 for one per core; never more than that
+    };
+
+    struct BatchResult {
+        std::uint64_t games = 0, wins = 0, losses = 0, unfinished = 0;
+        std::size_t threads = 0;
+        double seconds = 0.0;
+
+        double gamesPerSecond() const { return seconds > 0.0 ? games / seconds : 0.0; }
+        double gamesPerSecondPerCore() const { return threads ? gamesPerSecond() / threads : 0.0; }
+    };
+
+    // Plays many independent games across all cores, for evaluating bots
+    // and tuning density. Every worker thread keeps one Game (with debug
+    // output and undo history off) and reinitializes it for each game, so
+    // a warm worker does not reallocate the board. Workers tally their own
+    // results and add them to the shared total once, at the end. Results
+    // depend only on the config and the player, not on the thread count.
+    class EXPORT_API BatchSimulator {
+    public:
+        BatchResult run(const BatchConfig& config, const Player& player) const;
+        BatchResult run(const BatchConfig& config) const;
+
+        // Default player: opens the centre, then flags and chords every
+        // number it can; when stuck it reveals a random hidden cell
+        static void simplePlayer(Game& game, RandomGenerator& rng);
+    };
+}
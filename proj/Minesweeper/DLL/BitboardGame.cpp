@@ -0,0 +1,408 @@
+#include "BitboardGame.h"
+#include "Generation.h"
+#include <random>
+#include <queue>
+#include <algorithm>
+#include <stdexcept>
+#include <bit>
+
+namespace Minesweeper {
+
+    namespace {
+
+        // Cells whose west neighbour (x - 1) is set in row
+        std::uint64_t fromWest(const std::uint64_t* row, std::size_t w) {
+            return (row[w] << 1) | (w > 0 ? row[w - 1] >> 63 : 0);
+        }
+
+        // Cells whose east neighbour (x + 1) is set in row
+        std::uint64_t fromEast(const std::uint64_t* row, std::size_t w, std::size_t words) {
+            return (row[w] >> 1) | (w + 1 < words ? row[w + 1] << 63 : 0);
+        }
+
+        // Adds a one-bit-per-cell input to a 4-bit bit-sliced counter
+        void addBitSliced(std::uint64_t (&c)[4], std::uint64_t carry) {
+            for (int k = 0; k < 3; ++k) {
+                const std::uint64_t next = c[k] & carry;
+                c[k] ^= carry;
+                carry = next;
+            }
+            c[3] |= carry;
+        }
+    }
+
+    void BitboardGame::initialize(unsigned int s) {
+        initialize(s, s);
+    }
+
+    void BitboardGame::initialize(unsigned int w, unsigned int h) {
+        std::random_device rd;
+        initialize(w, h, Seed{ (static_cast<std::uint64_t>(rd()) << 32) ^ rd() });
+    }
+
+    void BitboardGame::initialize(unsigned int s, Seed seedValue) {
+        initialize(s, s, seedValue);
+    }
+
+    void BitboardGame::initialize(unsigned int w, unsigned int h, Seed seedValue) {
+        resetBoard(w, h);
+        seed = seedValue.value;
+        rng.seed(seed);
+    }
+
+    void BitboardGame::resetBoard(unsigned int w, unsigned int h) {
+        if (w == 0 || h == 0)
+            throw std::invalid_argument("Board dimensions must be positive.");
+
+        width = w;
+        height = h;
+        wordsPerRow = (static_cast<std::size_t>(width) + 63) / 64;
+        lastWordMask = (width % 64 == 0) ? ~std::uint64_t(0) : (std::uint64_t(1) << (width % 64)) - 1;
+
+        const std::size_t words = (static_cast<std::size_t>(height) + 2) * wordsPerRow;
+        for (Plane* plane : { &mines, &revealed, &flagged, &questioned, &counts[0], &counts[1],
+                              &counts[2], &counts[3], &zero, &fill }) {
+            plane->assign(words, 0);
+        }
+        rowStamp.assign(static_cast<std::size_t>(height) + 2, 0);
+        fillEpoch = 0;
+
+        mineCount = 0;
+        revealedSafeCount = 0;
+        flagCount = 0;
+        isInitialized = false;  // Wait for first click
+        gameOver = false;
+    }
+
+    void BitboardGame::initializeWithMines(unsigned int w, unsigned int h,
+        const std::vector<std::pair<unsigned int, unsigned int>>& mineList) {
+        initialize(w, h, Seed{});
+
+        for (const auto& [x, y] : mineList) {
+            if (x >= width || y >= height)
+                throw std::out_of_range("Mine position outside the board.");
+            if (!test(mines, x, y)) {
+                mines[wordIndex(x, y)] |= bitOf(x);
+                ++mineCount;
+            }
+        }
+
+        computeAdjacency();
+        isInitialized = true;
+    }
+
+    void BitboardGame::placeMines(unsigned int safeX, unsigned int safeY) {
+        // 1. Generate safe zone (same breadth-first order as Game)
+        Plane safe(mines.size(), 0);
+        std::vector<std::pair<unsigned int, unsigned int>> safeZone;
+        std::queue<std::pair<unsigned int, unsigned int>> q;
+
+        q.push({ safeX, safeY });
+        safeZone.push_back({ safeX, safeY });
+        safe[wordIndex(safeX, safeY)] |= bitOf(safeX);
+
+        while (!q.empty() && safeZone.size() < safeParam) {
+            auto [x, y] = q.front(); q.pop();
+
+            for (int dy = -1; dy <= 1 && safeZone.size() < safeParam; ++dy) {
+                for (int dx = -1; dx <= 1 && safeZone.size() < safeParam; ++dx) {
+                    int nx = static_cast<int>(x) + dx;
+                    int ny = static_cast<int>(y) + dy;
+                    if (dx == 0 && dy == 0) continue;
+                    if (nx >= 0 && ny >= 0 && nx < static_cast<int>(width) && ny < static_cast<int>(height)
+                        && !test(safe, nx, ny)) {
+                        safe[wordIndex(nx, ny)] |= bitOf(nx);
+                        safeZone.push_back({ (unsigned int)nx, (unsigned int)ny });
+                        q.push({ (unsigned int)nx, (unsigned int)ny });
+                    }
+                }
+            }
+        }
+
+        if (safeZone.size() != safeParam)
+            throw std::runtime_error("Failed to create a safe zone.");
+
+        // 2. Forbid the safe zone and its neighbours: one dilation step
+        Plane forbidden(mines.size(), 0);
+        for (std::size_t y = 0; y < height; ++y) {
+            for (std::size_t w = 0; w < wordsPerRow; ++w) {
+                std::uint64_t d = 0;
+                for (std::size_t r = y; r <= y + 2; ++r) {
+                    const std::uint64_t* row = &safe[r * wordsPerRow];
+                    d |= row[w] | fromWest(row, w) | fromEast(row, w, wordsPerRow);
+                }
+                forbidden[(y + 1) * wordsPerRow + w] = d;
+            }
+        }
+
+        // 3. Share the mines out between bands as Game does, then draw each
+        //    band's with a partial Fisher-Yates shuffle over its allowed
+        //    cells in row-major order
+        const std::size_t bands = Generation::bandCount(height);
+        std::vector<std::uint64_t> allowed(bands), quotas(bands);
+        for (std::size_t y = 0; y < height; ++y) {
+            for (std::size_t w = 0; w < wordsPerRow; ++w) {
+                const std::uint64_t mask = (w + 1 == wordsPerRow) ? lastWordMask : ~std::uint64_t(0);
+                allowed[y / Generation::BandRows] += std::popcount(~forbidden[(y + 1) * wordsPerRow + w] & mask);
+            }
+        }
+
+        std::uint64_t allowedTotal = 0;
+        for (std::uint64_t count : allowed)
+            allowedTotal += count;
+        const std::uint64_t requested = static_cast<std::uint64_t>(static_cast<double>(width) * height * mineDensity);
+        mineCount = std::min<std::uint64_t>(requested, allowedTotal);
+        Generation::bandQuotas(allowed.data(), quotas.data(), bands, mineCount);
+
+        const std::uint64_t boardKey = rng.next();
+        for (std::size_t band = 0; band < bands; ++band) {
+            Philox4x32 generator = Generation::bandGenerator(boardKey, band);
+
+            const std::size_t firstRow = band * Generation::BandRows;
+            const std::size_t lastRow = std::min<std::size_t>(firstRow + Generation::BandRows, height);
+            candidates.clear();
+            for (std::size_t y = firstRow; y < lastRow; ++y) {
+                for (std::size_t w = 0; w < wordsPerRow; ++w) {
+                    const std::uint64_t mask = (w + 1 == wordsPerRow) ? lastWordMask : ~std::uint64_t(0);
+                    for (std::uint64_t open = ~forbidden[(y + 1) * wordsPerRow + w] & mask; open; open &= open - 1)
+                        candidates.push_back(y * width + w * 64 + std::countr_zero(open));
+                }
+            }
+
+            for (std::uint64_t k = 0; k < quotas[band]; ++k) {
+                std::swap(candidates[k], candidates[k + generator.below(candidates.size() - k)]);
+                const unsigned int x = static_cast<unsigned int>(candidates[k] % width);
+                const unsigned int y = static_cast<unsigned int>(candidates[k] / width);
+                mines[wordIndex(x, y)] |= bitOf(x);
+            }
+        }
+
+        // 4. Count adjacent mines
+        computeAdjacency();
+
+        // 5. Reveal safe zone
+        for (const auto& [x, y] : safeZone) {
+            floodFillReveal(x, y);
+        }
+
+        isInitialized = true;
+    }
+
+    void BitboardGame::computeAdjacency() {
+        for (std::size_t y = 0; y < height; ++y) {
+            const std::uint64_t* above = &mines[y * wordsPerRow];
+            const std::uint64_t* row = above + wordsPerRow;
+            const std::uint64_t* below = row + wordsPerRow;
+
+            for (std::size_t w = 0; w < wordsPerRow; ++w) {
+                std::uint64_t c[4] = {};
+                addBitSliced(c, fromWest(above, w));
+                addBitSliced(c, above[w]);
+                addBitSliced(c, fromEast(above, w, wordsPerRow));
+                addBitSliced(c, fromWest(row, w));
+                addBitSliced(c, fromEast(row, w, wordsPerRow));
+                addBitSliced(c, fromWest(below, w));
+                addBitSliced(c, below[w]);
+                addBitSliced(c, fromEast(below, w, wordsPerRow));
+
+                const std::uint64_t mask = (w + 1 == wordsPerRow) ? lastWordMask : ~std::uint64_t(0);
+                const std::size_t i = (y + 1) * wordsPerRow + w;
+                for (int k = 0; k < 4; ++k)
+                    counts[k][i] = c[k] & mask;
+                zero[i] = ~(c[0] | c[1] | c[2] | c[3]) & ~row[w] & mask;
+            }
+        }
+    }
+
+    void BitboardGame::floodFillReveal(unsigned int x, unsigned int y) {
+        const std::size_t seed = wordIndex(x, y);
+        const std::uint64_t seedBit = bitOf(x);
+        if ((revealed[seed] | flagged[seed] | questioned[seed]) & seedBit) return;
+
+        // A numbered cell only reveals itself
+        if (!(zero[seed] & seedBit)) {
+            revealed[seed] |= seedBit;
+            ++revealedSafeCount;
+            return;
+        }
+
+        // Grow the region from the seed: each sweep adds every hidden cell
+        // touching a zero cell already in the region, until nothing changes.
+        // Sweeps alternate direction so long regions converge quickly, and
+        // only rows next to a row that grew in the last two sweeps are
+        // revisited, within the word columns the region has reached so far.
+        fill[seed] |= seedBit;
+        std::size_t lo = y, hi = y;
+        std::size_t wlo = x / 64, whi = x / 64;
+        std::uint64_t sweep = ++fillEpoch;
+        rowStamp[y + 1] = sweep;
+        bool changed = true;
+        bool downward = true;
+
+        while (changed) {
+            changed = false;
+            const std::size_t from = lo > 0 ? lo - 1 : 0;
+            const std::size_t to = std::min<std::size_t>(hi + 1, height - 1);
+            const std::size_t wFrom = wlo > 0 ? wlo - 1 : 0;
+            const std::size_t wTo = std::min(whi + 1, wordsPerRow - 1);
+
+            for (std::size_t step = 0; step <= to - from; ++step) {
+                const std::size_t r = downward ? from + step : to - step;
+                if (std::max({ rowStamp[r], rowStamp[r + 1], rowStamp[r + 2] }) + 1 < sweep) continue;
+
+                const std::size_t base = (r + 1) * wordsPerRow;
+                for (std::size_t w = wFrom; w <= wTo; ++w) {
+                    std::uint64_t d = 0;
+                    for (std::size_t rr = base - wordsPerRow; rr <= base + wordsPerRow; rr += wordsPerRow) {
+                        const std::uint64_t west = w > 0 ? fill[rr + w - 1] & zero[rr + w - 1] : 0;
+                        const std::uint64_t mid = fill[rr + w] & zero[rr + w];
+                        const std::uint64_t east = w + 1 < wordsPerRow ? fill[rr + w + 1] & zero[rr + w + 1] : 0;
+                        d |= mid | (mid << 1) | (mid >> 1) | (west >> 63) | (east << 63);
+                    }
+
+                    const std::size_t i = base + w;
+                    const std::uint64_t mask = (w + 1 == wordsPerRow) ? lastWordMask : ~std::uint64_t(0);
+                    const std::uint64_t hidden = ~(revealed[i] | flagged[i] | questioned[i]) & mask;
+                    const std::uint64_t added = d & hidden & ~fill[i];
+                    if (added) {
+                        fill[i] |= added;
+                        rowStamp[r + 1] = sweep;
+                        changed = true;
+                        lo = std::min(lo, r);
+                        hi = std::max(hi, r);
+                        wlo = std::min(wlo, w);
+                        whi = std::max(whi, w);
+                    }
+                }
+            }
+            downward = !downward;
+            ++sweep;
+        }
+        fillEpoch = sweep;
+
+        // Commit the region and clear the work plane for the next call
+        for (std::size_t r = lo + 1; r <= hi + 1; ++r) {
+            for (std::size_t i = r * wordsPerRow + wlo; i <= r * wordsPerRow + whi; ++i) {
+                revealed[i] |= fill[i];
+                revealedSafeCount += std::popcount(fill[i]);
+                fill[i] = 0;
+            }
+        }
+    }
+
+    bool BitboardGame::reveal(unsigned int x, unsigned int y) {
+        if (x >= width || y >= height) return true; // ignore out of bounds
+
+        if (!isInitialized) {
+            placeMines(x, y);
+        }
+
+        const std::size_t i = wordIndex(x, y);
+        const std::uint64_t bit = bitOf(x);
+        if ((revealed[i] | flagged[i]) & bit) return true;
+
+        // If it's a mine, game over
+        if (mines[i] & bit) {
+            revealed[i] |= bit;
+            gameOver = true;
+            return false;
+        }
+
+        // Flood fill reveal
+        floodFillReveal(x, y);
+        return true;
+    }
+
+    void BitboardGame::toggleFlag(unsigned int x, unsigned int y) {
+        if (x >= width || y >= height) return;
+        const std::size_t i = wordIndex(x, y);
+        const std::uint64_t bit = bitOf(x);
+        if (revealed[i] & bit) return;
+
+        if (flagged[i] & bit) {
+            flagged[i] &= ~bit;
+            questioned[i] |= bit;
+            --flagCount;
+        }
+        else if (questioned[i] & bit) {
+            questioned[i] &= ~bit;
+        }
+        else {
+            flagged[i] |= bit;
+            ++flagCount;
+        }
+    }
+
+    unsigned int BitboardGame::getWidth() const {
+        return width;
+    }
+
+    unsigned int BitboardGame::getHeight() const {
+        return height;
+    }
+
+    Cell BitboardGame::cellAt(unsigned int x, unsigned int y) const {
+        const std::size_t i = wordIndex(x, y);
+        const std::uint64_t bit = bitOf(x);
+
+        Cell cell;
+        cell.setMine((mines[i] & bit) != 0);
+
+        unsigned int count = 0;
+        for (int k = 0; k < 4; ++k) {
+            if (counts[k][i] & bit)
+                count |= 1u << k;
+        }
+        cell.setAdjacentMines(count);
+
+        if (revealed[i] & bit) cell.setState(CellState::Revealed);
+        else if (flagged[i] & bit) cell.setState(CellState::Flagged);
+        else if (questioned[i] & bit) cell.setState(CellState::Questioned);
+        return cell;
+    }
+
+    std::size_t BitboardGame::memoryFootprint() const {
+        std::size_t words = mines.capacity() + revealed.capacity() + flagged.capacity()
+            + questioned.capacity() + zero.capacity() + fill.capacity() + rowStamp.capacity()
+            + candidates.capacity();
+        for (const Plane& plane : counts)
+            words += plane.capacity();
+        return sizeof(BitboardGame) + words * sizeof(std::uint64_t);
+    }
+
+    bool BitboardGame::checkWin() const {
+        // Win if all non-mine cells are revealed
+        return revealedSafeCount == static_cast<std::uint64_t>(width) * height - mineCount;
+    }
+
+    std::uint64_t BitboardGame::getSeed() const {
+        return seed;
+    }
+
+    void BitboardGame::setMineDensity(double density) {
+        if (density < 0.0 || density > 1.0)
+            throw std::invalid_argument("Mine density must be between 0 and 1.");
+        mineDensity = density;
+    }
+
+    double BitboardGame::getMineDensity() const {
+        return mineDensity;
+    }
+
+    std::uint64_t BitboardGame::getMineCount() const {
+        return mineCount;
+    }
+
+    std::int64_t BitboardGame::remainingMines() const {
+        return static_cast<std::int64_t>(mineCount) - static_cast<std::int64_t>(flagCount);
+    }
+
+    bool BitboardGame::isGameOver() const {
+        return gameOver;
+    }
+
+    bool BitboardGame::hasEnded() const {
+        return gameOver || checkWin();
+    }
+
+} // namespace Minesweeper
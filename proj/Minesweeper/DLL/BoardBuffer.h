@@ -0,0 +1,68 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+namespace Minesweeper {
+
+    // Contiguous per-cell buffer used by Game. It either owns its memory or
+    // views memory owned elsewhere (a mapped board file); indexing is the
+    // same in both cases.
+    template <typename T>
+    class BoardBuffer {
+    public:
+        BoardBuffer() = default;
+        BoardBuffer(BoardBuffer&&) = default;
+        BoardBuffer& operator=(BoardBuffer&&) = default;
+        BoardBuffer(const BoardBuffer&) = delete;
+        BoardBuffer& operator=(const BoardBuffer&) = delete;
+
+        T& operator[](std::uint64_t i) { return cells[i]; }
+        const T& operator[](std::uint64_t i) const { return cells[i]; }
+
+        T* data() { return cells; }
+        const T* data() const { return cells; }
+        std::uint64_t size() const { return count; }
+
+        // Heap capacity in elements; 0 while viewing external memory
+        std::size_t capacity() const { return owned.capacity(); }
+
+        // Switch to owned storage of n copies of value
+        void assign(std::uint64_t n, const T& value) {
+            owned.assign(n, value);
+            cells = owned.data();
+            count = n;
+        }
+
+        // Switch to owned storage of n elements, keeping the owned contents
+        void resize(std::uint64_t n) {
+            owned.resize(n);
+            cells = owned.data();
+            count = n;
+        }
+
+        // Exchange owned storage with v
+        void swap(std::vector<T>& v) {
+            owned.swap(v);
+            cells = owned.data();
+            count = owned.size();
+        }
+
+        // View n elements at external; the caller keeps that memory alive
+        void attach(T* external, std::uint64_t n) {
+            std::vector<T>().swap(owned);
+            cells = external;
+            count = n;
+        }
+
+        void clear() {
+            std::vector<T>().swap(owned);
+            cells = nullptr;
+            count = 0;
+        }
+
+    private:
+        std::vector<T> owned;
+        T* cells = nullptr;
+        std::uint64_t count = 0;
+    };
+}
@@ -0,0 +1,139 @@
+#include "ChunkStore.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace Minesweeper {
+
+    namespace {
+
+        // PackBits: a header byte h < 128 is followed by h + 1 literal bytes,
+        // h >= 128 by one byte repeated h - 125 times (3 to 130). Worst case
+        // grows the input by one byte in 128.
+        void packBits(const std::uint8_t* data, std::size_t size, std::vector<std::uint8_t>& out) {
+            out.clear();
+            std::size_t i = 0;
+            while (i < size) {
+                std::size_t run = 1;
+                while (i + run < size && run < 130 && data[i + run] == data[i])
+                    ++run;
+
+                if (run >= 3) {
+                    out.push_back(static_cast<std::uint8_t>(run + 125));
+                    out.push_back(data[i]);
+                    i += run;
+                    continue;
+                }
+
+                // Literal stretch up to the next run of three
+                std::size_t length = 0;
+                while (i + length < size && length < 128) {
+                    if (i + length + 2 < size && data[i + length] == data[i + length + 1]
+                        && data[i + length] == data[i + length + 2])
+                        break;
+                    ++length;
+                }
+                out.push_back(static_cast<std::uint8_t>(length - 1));
+                out.insert(out.end(), data + i, data + i + length);
+                i += length;
+            }
+        }
+
+        bool unpackBits(const std::uint8_t* in, std::size_t inSize, std::uint8_t* data, std::size_t size) {
+            std::size_t i = 0, o = 0;
+            while (i < inSize) {
+                const std::uint8_t header = in[i++];
+                if (header < 128) {
+                    const std::size_t length = header + 1u;
+                    if (i + length > inSize || o + length > size)
+                        return false;
+                    std::copy(in + i, in + i + length, data + o);
+                    i += length;
+                    o += length;
+                }
+                else {
+                    const std::size_t run = header - 125u;
+                    if (i >= inSize || o + run > size)
+                        return false;
+                    std::fill_n(data + o, run, in[i++]);
+                    o += run;
+                }
+            }
+            return o == size;
+        }
+    }
+
+    void ChunkStore::open(const std::string& storePath) {
+        close();
+        file.open(storePath, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!file)
+            throw std::runtime_error("Failed to open chunk store.");
+        path = storePath;
+    }
+
+    void ChunkStore::close() {
+        if (file.is_open())
+            file.close();
+        file.clear();
+        index.clear();
+        fileEnd = 0;
+    }
+
+    bool ChunkStore::isOpen() const {
+        return file.is_open();
+    }
+
+    void ChunkStore::clear() {
+        if (isOpen())
+            open(std::string(path));
+    }
+
+    void ChunkStore::write(std::uint64_t key, const std::uint8_t* data, std::size_t size) {
+        packBits(data, size, buffer);
+        const std::uint32_t packed = static_cast<std::uint32_t>(buffer.size());
+
+        auto [it, inserted] = index.try_emplace(key, Extent{ fileEnd, packed, packed });
+        Extent& extent = it->second;
+        if (inserted) {
+            fileEnd += packed;
+        }
+        else if (packed > extent.capacity) {
+            extent = { fileEnd, packed, packed };
+            fileEnd += packed;
+        }
+        else {
+            extent.size = packed;
+        }
+
+        file.seekp(static_cast<std::streamoff>(extent.offset));
+        file.write(reinterpret_cast<const char*>(buffer.data()), packed);
+        if (!file)
+            throw std::runtime_error("Failed to write chunk store.");
+    }
+
+    bool ChunkStore::read(std::uint64_t key, std::uint8_t* data, std::size_t size) {
+        const auto it = index.find(key);
+        if (it == index.end())
+            return false;
+
+        buffer.resize(it->second.size);
+        file.seekg(static_cast<std::streamoff>(it->second.offset));
+        file.read(reinterpret_cast<char*>(buffer.data()), it->second.size);
+        if (!file || !unpackBits(buffer.data(), buffer.size(), data, size))
+            throw std::runtime_error("Chunk store record is damaged.");
+        return true;
+    }
+
+    bool ChunkStore::contains(std::uint64_t key) const {
+        return index.count(key) != 0;
+    }
+
+    std::size_t ChunkStore::storedCount() const {
+        return index.size();
+    }
+
+    std::size_t ChunkStore::memoryFootprint() const {
+        return index.size() * (sizeof(std::uint64_t) + sizeof(Extent) + sizeof(void*))
+            + index.bucket_count() * sizeof(void*) + buffer.capacity();
+    }
+
+} // namespace Minesweeper
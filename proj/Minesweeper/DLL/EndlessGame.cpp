@@ -0,0 +1,325 @@
+#include "EndlessGame.h"
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+
+namespace Minesweeper {
+
+    namespace {
+
+        // Stateless SplitMix64 finalizer, used as a counter-based hash
+        std::uint64_t mix(std::uint64_t value) {
+            return splitMix64(value);
+        }
+
+        std::int64_t chunkCoord(std::int64_t v) {
+            return v >> EndlessGame::ChunkBits;  // arithmetic shift floors negatives
+        }
+    }
+
+    void EndlessGame::initialize() {
+        std::random_device rd;
+        initialize(Seed{ (static_cast<std::uint64_t>(rd()) << 32) ^ rd() });
+    }
+
+    void EndlessGame::initialize(Seed seedValue) {
+        seed = seedValue.value;
+        // 2^64 * density, saturating at density 1
+        mineThreshold = mineDensity >= 1.0 ? ~std::uint64_t(0)
+            : static_cast<std::uint64_t>(mineDensity * 18446744073709551616.0);
+        chunks.clear();
+        lru.clear();
+        store.clear();
+        cachedChunk = nullptr;
+        started = false;
+        gameOver = false;
+        revealed = 0;
+        flags = 0;
+        fillStack.clear();
+    }
+
+    void EndlessGame::setMineDensity(double density) {
+        if (density < 0.0 || density > 1.0)
+            throw std::invalid_argument("Mine density must be between 0 and 1.");
+        mineDensity = density;
+    }
+
+    double EndlessGame::getMineDensity() const {
+        return mineDensity;
+    }
+
+    void EndlessGame::setChunkStore(const std::string& path, std::size_t memoryBudget) {
+        if (started)
+            throw std::runtime_error("Chunk store must be set before the first reveal.");
+
+        store.open(path);
+        // A resident chunk costs its map node and its LRU list node
+        const std::size_t chunkBytes = sizeof(Chunk) + 4 * sizeof(void*) + 2 * sizeof(std::uint64_t);
+        maxResident = std::max(memoryBudget / chunkBytes, MinResidentChunks);
+        evict();
+    }
+
+    void EndlessGame::flushChunks() {
+        if (!store.isOpen()) return;
+
+        for (auto& [key, chunk] : chunks) {
+            if (chunk.dirty) {
+                store.write(key, reinterpret_cast<const std::uint8_t*>(chunk.cells.data()), ChunkCells);
+                chunk.dirty = false;
+            }
+        }
+    }
+
+    std::uint64_t EndlessGame::chunkKey(std::int64_t cx, std::int64_t cy) {
+        return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(cx)) << 32) | static_cast<std::uint32_t>(cy);
+    }
+
+    bool EndlessGame::mineAt(std::int64_t x, std::int64_t y) const {
+        // The first click and its neighbours stay clear, so it opens a region
+        const std::int64_t dx = x - startX, dy = y - startY;
+        if (dx >= -1 && dx <= 1 && dy >= -1 && dy <= 1)
+            return false;
+
+        const std::uint64_t chunkSeed = mix(seed ^ mix(chunkKey(chunkCoord(x), chunkCoord(y))));
+        return mix(chunkSeed + localIndex(x, y)) < mineThreshold;
+    }
+
+    void EndlessGame::generateChunk(Chunk& chunk, std::int64_t cx, std::int64_t cy) const {
+        const std::int64_t x0 = cx * ChunkSize, y0 = cy * ChunkSize;
+
+        // Mines of the chunk plus a one-cell ring taken from the neighbours'
+        // layout, which the hash gives without creating those chunks
+        constexpr std::int64_t Span = ChunkSize + 2;
+        std::array<bool, Span * Span> mines;
+        for (std::int64_t y = 0; y < Span; ++y) {
+            for (std::int64_t x = 0; x < Span; ++x)
+                mines[y * Span + x] = mineAt(x0 + x - 1, y0 + y - 1);
+        }
+
+        for (std::int64_t y = 0; y < ChunkSize; ++y) {
+            for (std::int64_t x = 0; x < ChunkSize; ++x) {
+                const std::int64_t centre = (y + 1) * Span + x + 1;
+                unsigned int count = 0;
+                for (std::int64_t dy = -1; dy <= 1; ++dy) {
+                    for (std::int64_t dx = -1; dx <= 1; ++dx) {
+                        if ((dx != 0 || dy != 0) && mines[centre + dy * Span + dx])
+                            ++count;
+                    }
+                }
+
+                Cell& c = chunk.cells[static_cast<std::size_t>(y * ChunkSize + x)];
+                c = Cell{};
+                c.setMine(mines[centre]);
+                c.setAdjacentMines(count);
+            }
+        }
+    }
+
+    EndlessGame::Chunk* EndlessGame::residentChunk(std::uint64_t key, bool create) {
+        const auto it = chunks.find(key);
+        if (it != chunks.end()) {
+            lru.splice(lru.begin(), lru, it->second.lruPos);
+            return &it->second;
+        }
+
+        // A chunk with a stored copy must come back from the store; one that
+        // was never written can simply be generated again
+        const bool stored = store.contains(key);
+        if (!stored && !create)
+            return nullptr;
+
+        Chunk& chunk = chunks[key];
+        if (stored)
+            store.read(key, reinterpret_cast<std::uint8_t*>(chunk.cells.data()), ChunkCells);
+        else
+            generateChunk(chunk, chunkX(key), chunkY(key));
+
+        lru.push_front(key);
+        chunk.lruPos = lru.begin();
+        evict();
+        return &chunk;
+    }
+
+    void EndlessGame::evict() {
+        if (maxResident == 0) return;
+
+        while (chunks.size() > maxResident) {
+            const std::uint64_t key = lru.back();
+            const auto it = chunks.find(key);
+
+            // Clean chunks match their stored or generated form already
+            if (it->second.dirty)
+                store.write(key, reinterpret_cast<const std::uint8_t*>(it->second.cells.data()), ChunkCells);
+
+            chunks.erase(it);
+            lru.pop_back();
+            if (cachedKey == key)
+                cachedChunk = nullptr;
+        }
+    }
+
+    Cell& EndlessGame::cell(std::int64_t x, std::int64_t y) {
+        const std::uint64_t key = chunkKey(chunkCoord(x), chunkCoord(y));
+        if (!cachedChunk || cachedKey != key) {
+            cachedChunk = residentChunk(key, true);
+            cachedKey = key;
+        }
+        return cachedChunk->cells[localIndex(x, y)];
+    }
+
+    void EndlessGame::setCellState(Cell& c, CellState state) {
+        c.setState(state);
+        cachedChunk->dirty = true;
+    }
+
+    Cell EndlessGame::cellAt(std::int64_t x, std::int64_t y) {
+        const std::uint64_t key = chunkKey(chunkCoord(x), chunkCoord(y));
+        if (!cachedChunk || cachedKey != key) {
+            Chunk* chunk = residentChunk(key, false);
+            if (!chunk)
+                return Cell{};
+            cachedChunk = chunk;
+            cachedKey = key;
+        }
+        return cachedChunk->cells[localIndex(x, y)];
+    }
+
+    bool EndlessGame::reveal(std::int64_t x, std::int64_t y) {
+        return beginReveal(x, y, RevealLimit);
+    }
+
+    bool EndlessGame::beginReveal(std::int64_t x, std::int64_t y, std::uint64_t budget) {
+        if (gameOver) return false;
+
+        if (!started) {
+            startX = x;
+            startY = y;
+            started = true;
+        }
+
+        Cell& c = cell(x, y);
+
+        // A revealed zero cell may border cells a capped fill has not opened
+        // yet: carry the fill on from there first
+        if (c.state() == CellState::Revealed && c.adjacentMines() == 0 && !c.hasMine()) {
+            fillStack.emplace_back(x, y);
+            continueFill(std::max<std::uint64_t>(budget, 1));
+            return true;
+        }
+        if (c.state() == CellState::Revealed || c.state() == CellState::Flagged) return true;
+
+        if (c.hasMine()) {
+            setCellState(c, CellState::Revealed);
+            gameOver = true;
+            return false;
+        }
+
+        floodFillReveal(x, y, std::max<std::uint64_t>(budget, 1));
+        return true;
+    }
+
+    void EndlessGame::continueReveal(std::uint64_t budget) {
+        if (!gameOver)
+            continueFill(std::max<std::uint64_t>(budget, 1));
+    }
+
+    bool EndlessGame::isRevealPending() const {
+        return !gameOver && !fillStack.empty();
+    }
+
+    void EndlessGame::floodFillReveal(std::int64_t x, std::int64_t y, std::uint64_t budget) {
+        Cell& start = cell(x, y);
+        if (start.state() != CellState::Hidden) return;
+
+        setCellState(start, CellState::Revealed);
+        ++revealed;
+        if (start.adjacentMines() != 0 || start.hasMine()) return;
+
+        // Pushed on top of any frontier an earlier reveal left, so the new
+        // region is opened first and the old one is picked up after it
+        fillStack.emplace_back(x, y);
+        continueFill(budget - 1);
+    }
+
+    void EndlessGame::continueFill(std::uint64_t budget) {
+        // Same scheme as Game: reveal on push, push only zero cells. Chunks
+        // are created as the region reaches them.
+        std::uint64_t opened = 0;
+        while (!fillStack.empty() && opened < budget) {
+            const auto [cx, cy] = fillStack.back();
+            fillStack.pop_back();
+
+            for (std::int64_t dy = -1; dy <= 1; ++dy) {
+                for (std::int64_t dx = -1; dx <= 1; ++dx) {
+                    if (dx == 0 && dy == 0) continue;
+
+                    Cell& neighbour = cell(cx + dx, cy + dy);
+                    if (neighbour.state() != CellState::Hidden) continue;
+
+                    setCellState(neighbour, CellState::Revealed);
+                    ++revealed;
+                    ++opened;
+                    if (neighbour.adjacentMines() == 0 && !neighbour.hasMine())
+                        fillStack.emplace_back(cx + dx, cy + dy);
+                }
+            }
+        }
+    }
+
+    void EndlessGame::toggleFlag(std::int64_t x, std::int64_t y) {
+        if (!started || gameOver) return;
+
+        Cell& c = cell(x, y);
+        const CellState state = c.state();
+        if (state == CellState::Hidden) {
+            setCellState(c, CellState::Flagged);
+            ++flags;
+        }
+        else if (state == CellState::Flagged) {
+            setCellState(c, CellState::Questioned);
+            --flags;
+        }
+        else if (state == CellState::Questioned) {
+            setCellState(c, CellState::Hidden);
+        }
+    }
+
+    bool EndlessGame::isGameOver() const {
+        return gameOver;
+    }
+
+    bool EndlessGame::hasStarted() const {
+        return started;
+    }
+
+    std::uint64_t EndlessGame::getSeed() const {
+        return seed;
+    }
+
+    std::uint64_t EndlessGame::revealedCount() const {
+        return revealed;
+    }
+
+    std::uint64_t EndlessGame::flagCount() const {
+        return flags;
+    }
+
+    std::size_t EndlessGame::chunkCount() const {
+        return chunks.size();
+    }
+
+    std::size_t EndlessGame::storedChunkCount() const {
+        return store.storedCount();
+    }
+
+    std::size_t EndlessGame::memoryFootprint() const {
+        // Each map node holds its key, the chunk and a next pointer; each
+        // LRU node a key and two links
+        return sizeof(EndlessGame) + chunks.size() * (sizeof(std::uint64_t) + sizeof(Chunk) + sizeof(void*))
+            + chunks.bucket_count() * sizeof(void*)
+            + lru.size() * (sizeof(std::uint64_t) + 2 * sizeof(void*))
+            + store.memoryFootprint()
+            + fillStack.capacity() * sizeof(fillStack[0]);
+    }
+
+} // namespace Minesweeper
@@ -1,42 +1,168 @@
 #include "GameLogic.h"
+#include "Generation.h"
+#include "Parallel.h"
 #include <random>
 #include <iostream>
-#include <set>
-#include <queue>
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
 
 namespace Minesweeper {
 
+    // Brackets one public move: points the change sink at the caller's
+    // buffer and turns the cell changes into one journal entry at the end.
+    // A sliced reveal stays open across its slices and is committed once
+    // it is finished.
+    struct Game::MoveScope {
+        Game& game;
+        bool gameOverBefore;
+
+        MoveScope(Game& game, ChangeSet* changes) : game(game), gameOverBefore(game.gameOver) {
+            game.changeSink = changes;
+            if (changes)
+                changes->clear();
+            game.finishReveal();
+            game.journalling = true;
+        }
+
+        ~MoveScope() {
+            game.revealPending = game.slicedReveal && !game.fillStack.empty();
+            game.slicedReveal = false;
+            game.changeSink = nullptr;
+            game.journalling = false;
+            if (!game.revealPending)
+                game.journal.commit(gameOverBefore, game.gameOver);
+        }
+    };
+
+    template <typename Fn>
+    void Game::forEachBand(Fn&& fn) {
+        const std::size_t bands = Generation::bandCount(height);
+        if (bands == 1 || static_cast<std::uint64_t>(width) * height < ParallelCells) {
+            for (std::size_t band = 0; band < bands; ++band)
+                fn(band);
+            return;
+        }
+
+        parallelFor((bands + 1) / 2, [&](std::size_t i) { fn(2 * i); });
+        parallelFor(bands / 2, [&](std::size_t i) { fn(2 * i + 1); });
+    }
+
     void Game::initialize(unsigned int s) {
-        size = s;
-        grid.assign(size, std::vector<Cell>(size));
-        isInitialized = false;  // Wait for first click
+        initialize(s, s);
     }
 
-    std::unordered_set<std::pair<unsigned int, unsigned int>, pair_hash>
-        Game::generateSafeZone(unsigned int startX, unsigned int startY, unsigned int count) const {
-        std::unordered_set<std::pair<unsigned int, unsigned int>, pair_hash> safeZone;
-        std::queue<std::pair<unsigned int, unsigned int>> q;
-
-        q.push({ startX, startY });
-        safeZone.insert({ startX, startY });
-
-        while (!q.empty() && safeZone.size() < count) {
-            auto [x, y] = q.front(); q.pop();
-
-            for (int dy = -1; dy <= 1; ++dy) {
-                for (int dx = -1; dx <= 1; ++dx) {
-                    int nx = static_cast<int>(x) + dx;
-                    int ny = static_cast<int>(y) + dy;
-                    if (dx == 0 && dy == 0) continue;
-                    if (nx >= 0 && ny >= 0 && nx < static_cast<int>(size) && ny < static_cast<int>(size)) {
-                        std::pair<unsigned int, unsigned int> pos = { (unsigned int)nx, (unsigned int)ny };
-                        if (!safeZone.count(pos)) {
-                            safeZone.insert(pos);
-                            q.push(pos);
-                            if (safeZone.size() >= count) break;
-                        }
-                    }
+    void Game::initialize(unsigned int w, unsigned int h) {
+        std::random_device rd;
+        initialize(w, h, Seed{ (static_cast<std::uint64_t>(rd()) << 32) ^ rd() });
+    }
+
+    void Game::initialize(unsigned int s, Seed seedValue) {
+        initialize(s, s, seedValue);
+    }
+
+    Game::~Game() {
+        closeMapping();
+    }
+
+    void Game::initialize(unsigned int w, unsigned int h, Seed seedValue) {
+        closeMapping();
+        setDimensions(w, h);
+
+        const std::uint64_t cells = stride * (static_cast<std::uint64_t>(height) + 2);
+        grid.assign(cells, Cell{});
+        neighbourCounts.assign(cells, 0);
+        resetBoard(seedValue);
+    }
+
+    void Game::resetBoard(Seed seedValue) {
+        seed = seedValue.value;
+        rng->seed(seed);
+
+        // Sentinel ring: revealed and mine-free, so flood fill stops there
+        // and adjacency counts ignore it
+        Cell sentinel;
+        sentinel.setState(CellState::Revealed);
+        std::fill_n(grid.data(), grid.size(), sentinel);
+        std::fill_n(neighbourCounts.data(), neighbourCounts.size(), std::uint8_t(0));
+
+        // Every board cell starts with all its on-board neighbours hidden:
+        // 8 inside, 5 on an edge, 3 in a corner
+        forEachBand([&](std::size_t band) {
+            const unsigned int firstRow = static_cast<unsigned int>(band * Generation::BandRows);
+            const unsigned int lastRow = std::min(height, firstRow + Generation::BandRows);
+            for (unsigned int y = firstRow; y < lastRow; ++y) {
+                const std::uint64_t rowStart = index(0, y);
+                std::fill_n(grid.data() + rowStart, width, Cell{});
+
+                const unsigned int rows = 1 + (y > 0) + (y + 1 < height);
+                for (unsigned int x = 0; x < width; ++x) {
+                    const unsigned int columns = 1 + (x > 0) + (x + 1 < width);
+                    neighbourCounts[rowStart + x] = static_cast<std::uint8_t>((rows * columns - 1) << 4);
                 }
+            }
+        });
+
+        mineCount = 0;
+        openingsLabelled = false;
+        firstClickPos = { 0, 0 };
+        revealedSafeCount = 0;
+        flagCount = 0;
+        questionCount = 0;
+        isInitialized = false;  // Wait for first click
+        gameOver = false;
+        fillStack.clear();
+        revealPending = false;
+        journal.clear();
+    }
+
+    void Game::setDimensions(unsigned int w, unsigned int h) {
+        width = w;
+        height = h;
+        stride = static_cast<std::uint64_t>(width) + 2;
+
+        const std::int64_t s64 = static_cast<std::int64_t>(stride);
+        const std::int64_t offsets[8] = { -s64 - 1, -s64, -s64 + 1, -1, 1, s64 - 1, s64, s64 + 1 };
+        std::copy(std::begin(offsets), std::end(offsets), neighbourOffsets);
+    }
+
+    void Game::initializeWithMines(unsigned int w, unsigned int h,
+        const std::vector<std::pair<unsigned int, unsigned int>>& mines) {
+        initialize(w, h, Seed{});
+
+        for (const auto& [x, y] : mines) {
+            if (x >= width || y >= height)
+                throw std::out_of_range("Mine position outside the board.");
+            Cell& cell = grid[index(x, y)];
+            if (!cell.hasMine()) {
+                cell.setMine(true);
+                ++mineCount;
+            }
+        }
+
+        if (!lazyAdjacency)
+            computeAdjacency();
+        isInitialized = true;
+    }
+
+    std::vector<std::uint64_t> Game::generateSafeZone(unsigned int startX, unsigned int startY, unsigned int count) {
+        // Breadth-first from the start cell; the result vector doubles as the queue
+        // and the stencil marks cells already taken
+        std::vector<std::uint64_t> safeZone;
+        const std::uint64_t start = index(startX, startY);
+        safeZone.push_back(start);
+        markStencil(start);
+
+        for (std::size_t head = 0; head < safeZone.size() && safeZone.size() < count; ++head) {
+            for (std::int64_t offset : neighbourOffsets) {
+                const std::uint64_t n = safeZone[head] + offset;
+                if (!isInterior(n) || testStencil(n)) continue;
+
+                markStencil(n);
+                safeZone.push_back(n);
                 if (safeZone.size() >= count) break;
             }
         }
@@ -48,156 +174,750 @@ namespace Minesweeper {
     }
 
     void Game::placeMines(unsigned int safeX, unsigned int safeY) {
+        firstClickPos = { safeX, safeY };
+
         // 1. Generate safe zone
-        auto safeZone = generateSafeZone(safeX, safeY, safeParam);
+        stencil.assign(grid.size() / 64 + 1, 0);
+        const std::vector<std::uint64_t> safeZone = generateSafeZone(safeX, safeY, safeParam);
 
         // 2. Also forbid placing mines around the safe zone
-        std::unordered_set<std::pair<unsigned int, unsigned int>, pair_hash> forbidden;
-        for (const auto& [x, y] : safeZone) {
-            for (int dy = -1; dy <= 1; ++dy) {
-                for (int dx = -1; dx <= 1; ++dx) {
-                    int nx = static_cast<int>(x) + dx;
-                    int ny = static_cast<int>(y) + dy;
-                    if (nx >= 0 && ny >= 0 && nx < static_cast<int>(size) && ny < static_cast<int>(size)) {
-                        forbidden.insert({ (unsigned int)nx, (unsigned int)ny });
-                    }
+        for (std::uint64_t i : safeZone) {
+            for (std::int64_t offset : neighbourOffsets) {
+                markStencil(i + offset);
+            }
+        }
+
+        // 3. Share the mines out between bands of rows by their allowed
+        //    cells; only the few cells around the safe zone are closed
+        const std::size_t bands = Generation::bandCount(height);
+        std::vector<std::uint64_t> allowed(bands), quotas(bands);
+        for (std::size_t b = 0; b < bands; ++b) {
+            const unsigned int firstRow = static_cast<unsigned int>(b * Generation::BandRows);
+            allowed[b] = static_cast<std::uint64_t>(std::min(height - firstRow, Generation::BandRows)) * width;
+        }
+
+        std::vector<std::uint64_t> closed;
+        for (std::uint64_t i : safeZone) {
+            closed.push_back(i);
+            for (std::int64_t offset : neighbourOffsets) {
+                if (isInterior(i + offset))
+                    closed.push_back(i + offset);
+            }
+        }
+        std::sort(closed.begin(), closed.end());
+        closed.erase(std::unique(closed.begin(), closed.end()), closed.end());
+        for (std::uint64_t i : closed)
+            --allowed[(i / stride - 1) / Generation::BandRows];
+
+        std::uint64_t allowedTotal = 0;
+        for (std::uint64_t count : allowed)
+            allowedTotal += count;
+        const std::uint64_t requested = static_cast<std::uint64_t>(static_cast<double>(width) * height * mineDensity);
+        mineCount = std::min<std::uint64_t>(requested, allowedTotal);
+        Generation::bandQuotas(allowed.data(), quotas.data(), bands, mineCount);
+
+        // 4. Draw each band's mines with a partial Fisher-Yates shuffle
+        const std::uint64_t boardKey = rng->next();
+        if (bands == 1) {
+            Philox4x32 generator = Generation::bandGenerator(boardKey, 0);
+            drawBand(0, generator, quotas[0], candidates);
+        }
+        else {
+            forEachBand([&](std::size_t band) {
+                Philox4x32 generator = Generation::bandGenerator(boardKey, band);
+                std::vector<std::uint64_t> pool;
+                drawBand(band, generator, quotas[band], pool);
+            });
+        }
+
+        // 5. Debug output, skipped for boards too large to read on a console
+        constexpr std::uint64_t debugMapCells = 256 * 256;
+        if (debugOutput && static_cast<std::uint64_t>(width) * height <= debugMapCells) {
+            std::cout << "\nMinefield Map (Debug View):\n";
+            for (unsigned int y = 0; y < height; ++y) {
+                const Cell* row = &grid[index(0, y)];
+                for (unsigned int x = 0; x < width; ++x) {
+                    std::cout << (row[x].hasMine() ? " *" : " .");
                 }
+                std::cout << '\n';
             }
         }
 
-        // 3. Place mines outside the forbidden area
-        mineCount = static_cast<unsigned int>(size * size * 0.175);
-        unsigned int placed = 0;
+        // 6. Count adjacent mines, unless reveals count them as they go
+        if (!lazyAdjacency)
+            computeAdjacency();
 
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_int_distribution<> distX(0, size - 1);
-        std::uniform_int_distribution<> distY(0, size - 1);
+        // 7. Reveal safe zone
+        for (std::uint64_t i : safeZone) {
+            floodFillReveal(i);
+        }
+
+        isInitialized = true;
+    }
+
+    void Game::drawBand(std::size_t band, RandomGenerator& generator, std::uint64_t quota, std::vector<std::uint64_t>& pool) {
+        const unsigned int firstRow = static_cast<unsigned int>(band * Generation::BandRows);
+        const unsigned int lastRow = std::min(height, firstRow + Generation::BandRows);
 
-        while (placed < mineCount) {
-            unsigned int x = distX(gen);
-            unsigned int y = distY(gen);
-            std::pair<unsigned int, unsigned int> pos = { x, y };
+        pool.clear();
+        for (unsigned int y = firstRow; y < lastRow; ++y) {
+            const std::uint64_t rowStart = index(0, y);
+            for (std::uint64_t i = rowStart; i < rowStart + width; ++i) {
+                if (!testStencil(i))
+                    pool.push_back(i);
+            }
+        }
 
-            if (!grid[y][x].hasMine && forbidden.count(pos) == 0) {
-                grid[y][x].hasMine = true;
-                ++placed;
+        for (std::uint64_t k = 0; k < quota; ++k) {
+            std::swap(pool[k], pool[k + generator.below(pool.size() - k)]);
+            grid[pool[k]].setMine(true);
+        }
+    }
+
+    void Game::computeAdjacency() {
+        forEachBand([&](std::size_t band) {
+            const unsigned int firstRow = static_cast<unsigned int>(band * Generation::BandRows);
+            const unsigned int lastRow = std::min(height, firstRow + Generation::BandRows);
+            for (unsigned int y = firstRow; y < lastRow; ++y) {
+                const std::uint64_t rowStart = index(0, y);
+                for (std::uint64_t i = rowStart; i < rowStart + width; ++i) {
+                    grid[i].setAdjacentMines(countAdjacent(i));
+                }
             }
+        });
+    }
+
+
+    unsigned int Game::countAdjacent(std::uint64_t i) const {
+        // Sentinel cells never hold mines, so no bounds checks are needed
+        unsigned int count = 0;
+        for (std::int64_t offset : neighbourOffsets) {
+            if (grid[i + offset].hasMine())
+                ++count;
+        }
+        return count;
+    }
+
+    void Game::floodFillReveal(std::uint64_t i) {
+        // Base case: already revealed, flagged or a sentinel cell
+        Cell& cell = grid[i];
+        if (cell.state() != CellState::Hidden) return;
+
+        // A sliced reveal opens cells one by one so it can stop anywhere;
+        // earlier cells of the same slice may have left zero cells pending
+        if (slicedReveal) {
+            setCellState(i, CellState::Revealed);
+            revealBudget -= revealBudget != 0;
+            if (cell.adjacentMines() == 0 && !cell.hasMine())
+                fillStack.push_back(i);
+            continueFill();
+            return;
         }
 
-        // 4. Debug output
-        std::cout << "\nMinefield Map (Debug View):\n";
-        for (unsigned int y = 0; y < size; ++y) {
-            for (unsigned int x = 0; x < size; ++x) {
-                std::cout << (grid[y][x].hasMine ? " *" : " .");
+        if (!openingsLabelled && isInitialized && !lazyAdjacency && !mappedHeader
+            && static_cast<std::uint64_t>(width) * height <= LabelCells)
+            labelOpenings();
+
+        // A zero cell of an untouched opening: its cells are listed already
+        if (openingsLabelled && openingOf[i] != NoOpening && openingTouched[openingOf[i] - 1] == 0) {
+            const std::uint32_t opening = openingOf[i] - 1;
+            for (std::uint64_t k = openingStart[opening]; k < openingStart[opening + 1]; ++k) {
+                const std::uint64_t n = openingCells[k];
+                if (grid[n].state() == CellState::Hidden)
+                    setCellState(n, CellState::Revealed);
             }
-            std::cout << '\n';
+            return;
         }
 
-        // 5. Count adjacent mines
-        for (unsigned int y = 0; y < size; ++y) {
-            for (unsigned int x = 0; x < size; ++x) {
-                grid[y][x].adjacentMines = countAdjacent(x, y);
+        // Reveal this cell
+        setCellState(i, CellState::Revealed);
+        if (cell.adjacentMines() != 0 || cell.hasMine()) return;
+
+        // No adjacent mines: reveal neighbours with an explicit stack.
+        // Cells are revealed when pushed and only zero cells are pushed,
+        // so each cell enters the stack at most once and it never holds
+        // more than width * height entries. The buffer is kept between
+        // calls, so a warm reveal does not allocate.
+        fillStack.clear();
+        fillStack.push_back(i);
+
+        // Openings that turn out large are finished on all cores
+        std::uint64_t expanded = 0;
+
+        while (!fillStack.empty()) {
+            if (++expanded == ParallelRevealCells && hardwareThreads() > 1) {
+                parallelFloodFill();
+                return;
+            }
+
+            const std::uint64_t current = fillStack.back();
+            fillStack.pop_back();
+
+            for (std::int64_t offset : neighbourOffsets) {
+                const std::uint64_t n = current + offset;
+                Cell& neighbour = grid[n];
+                if (neighbour.state() != CellState::Hidden) continue;
+
+                setCellState(n, CellState::Revealed);
+                if (neighbour.adjacentMines() == 0 && !neighbour.hasMine())
+                    fillStack.push_back(n);
             }
         }
+    }
 
-        // 6. Reveal safe zone
-        for (const auto& [x, y] : safeZone) {
-            floodFillReveal(x, y);
+    void Game::continueFill() {
+        while (!fillStack.empty() && revealBudget != 0) {
+            const std::uint64_t current = fillStack.back();
+            fillStack.pop_back();
+
+            for (std::int64_t offset : neighbourOffsets) {
+                const std::uint64_t n = current + offset;
+                Cell& neighbour = grid[n];
+                if (neighbour.state() != CellState::Hidden) continue;
+
+                setCellState(n, CellState::Revealed);
+                revealBudget -= revealBudget != 0;
+                if (neighbour.adjacentMines() == 0 && !neighbour.hasMine())
+                    fillStack.push_back(n);
+            }
         }
+    }
 
-        isInitialized = true;
+    void Game::finishReveal() {
+        if (!revealPending) return;
+        revealPending = false;
+
+        // The rest goes into the change set of whatever move comes next
+        journalling = true;
+        if (hardwareThreads() > 1 && fillStack.size() > 1) {
+            parallelFloodFill();
+        }
+        else {
+            revealBudget = ~std::uint64_t(0);
+            continueFill();
+        }
+        journalling = false;
+        journal.commit(gameOver, gameOver);
     }
 
-    unsigned int Game::countAdjacent(unsigned int x, unsigned int y) const {
-        unsigned int count = 0;
-        for (int dy = -1; dy <= 1; ++dy) {
-            for (int dx = -1; dx <= 1; ++dx) {
-                if (dx == 0 && dy == 0) continue;
-                int nx = static_cast<int>(x) + dx;
-                int ny = static_cast<int>(y) + dy;
-                if (nx >= 0 && nx < static_cast<int>(size) && ny >= 0 && ny < static_cast<int>(size)) {
-                    if (grid[ny][nx].hasMine)
-                        ++count;
+    void Game::labelOpenings() const {
+        // Sentinels get a label of their own, so the search below needs no
+        // bounds checks. Counts come through adjacentMines(i), as a lazy
+        // board has filled in only those of the cells revealed so far.
+        openingOf.assign(grid.size(), SentinelOpening);
+        for (unsigned int y = 0; y < height; ++y)
+            std::fill_n(openingOf.data() + index(0, y), width, NoOpening);
+        openingStart.assign(1, 0);
+        openingCells.clear();
+        openingTouched.clear();
+
+        std::vector<std::uint64_t> stack;
+        for (unsigned int y = 0; y < height; ++y) {
+            const std::uint64_t rowStart = index(0, y);
+            for (std::uint64_t i = rowStart; i < rowStart + width; ++i) {
+                const Cell& cell = grid[i];
+                if (cell.hasMine() || openingOf[i] != NoOpening || adjacentMines(i) != 0) continue;
+
+                // New opening: depth-first over its zero cells, listing
+                // numbered neighbours as the border (a mine is never next
+                // to a zero cell)
+                const std::uint32_t label = static_cast<std::uint32_t>(openingTouched.size() + 1);
+                const std::size_t first = openingCells.size();
+                std::uint64_t touched = 0;
+                openingOf[i] = label;
+                stack.push_back(i);
+
+                while (!stack.empty()) {
+                    const std::uint64_t current = stack.back();
+                    stack.pop_back();
+                    openingCells.push_back(current);
+                    if (grid[current].state() != CellState::Hidden)
+                        ++touched;
+
+                    for (std::int64_t offset : neighbourOffsets) {
+                        const std::uint64_t n = current + offset;
+                        if (openingOf[n] == SentinelOpening) continue;
+                        if (adjacentMines(n) != 0) {
+                            openingCells.push_back(n);
+                        }
+                        else if (openingOf[n] == NoOpening) {
+                            openingOf[n] = label;
+                            stack.push_back(n);
+                        }
+                    }
                 }
+
+                // Border cells are reached from several zero cells
+                std::sort(openingCells.begin() + first, openingCells.end());
+                openingCells.erase(std::unique(openingCells.begin() + first, openingCells.end()), openingCells.end());
+                openingStart.push_back(openingCells.size());
+                openingTouched.push_back(touched);
             }
         }
-        return count;
+
+        openingsLabelled = true;
     }
 
-    void Game::floodFillReveal(unsigned int x, unsigned int y) {
-        // Base cases: out of bounds or already revealed or flagged
-        if (x >= size || y >= size) return;
-        Cell& cell = grid[y][x];
-        if (cell.state != CellState::Hidden) return;
+    void Game::parallelFloodFill() {
+        // Each thread works through a private stack and publishes its oldest
+        // entries to its shared queue once the stack grows, so idle threads
+        // have something to steal. pending counts zero cells pushed but not
+        // yet expanded; the fill is over when it drops to zero.
+        constexpr std::size_t shareBatch = 256;
+
+        struct alignas(64) Worker {
+            std::mutex lock;
+            std::deque<std::uint64_t> shared;
+            std::vector<std::uint64_t> revealed;  // for the journal and change set
+            std::uint64_t count = 0;
+        };
+
+        const std::size_t threads = hardwareThreads();
+        std::vector<Worker> workers(threads);
+        for (std::size_t k = 0; k < fillStack.size(); ++k)
+            workers[k % threads].shared.push_back(fillStack[k]);
+        std::atomic<std::uint64_t> pending{ fillStack.size() };
+        fillStack.clear();
+
+        const bool recording = changeSink || (journalling && journal.getDepth() != 0);
+
+        // Moves up to shareBatch cells from a queue into stack: the newest
+        // from the thread's own queue, the oldest (nearest the start of the
+        // fill, so likely to lead to more work) from a victim's
+        auto take = [&](std::size_t t, std::vector<std::uint64_t>& stack) {
+            for (std::size_t k = 0; k < threads; ++k) {
+                Worker& victim = workers[(t + k) % threads];
+                std::lock_guard<std::mutex> lock(victim.lock);
+                if (victim.shared.empty()) continue;
+
+                const std::size_t n = std::min(shareBatch, k == 0 ? victim.shared.size() : (victim.shared.size() + 1) / 2);
+                for (std::size_t j = 0; j < n; ++j) {
+                    if (k == 0) {
+                        stack.push_back(victim.shared.back());
+                        victim.shared.pop_back();
+                    }
+                    else {
+                        stack.push_back(victim.shared.front());
+                        victim.shared.pop_front();
+                    }
+                }
+                return true;
+            }
+            return false;
+        };
 
-        // Reveal this cell
-        cell.state = CellState::Revealed;
-
-        // If no adjacent mines, recursively reveal neighbors
-        if (cell.adjacentMines == 0 && !cell.hasMine) {
-            for (int dy = -1; dy <= 1; ++dy) {
-                for (int dx = -1; dx <= 1; ++dx) {
-                    if (dx == 0 && dy == 0) continue;
-                    int nx = static_cast<int>(x) + dx;
-                    int ny = static_cast<int>(y) + dy;
-                    if (nx >= 0 && nx < static_cast<int>(size) && ny >= 0 && ny < static_cast<int>(size)) {
-                        floodFillReveal(static_cast<unsigned int>(nx), static_cast<unsigned int>(ny));
+        parallelFor(threads, [&](std::size_t t) {
+            Worker& self = workers[t];
+            std::vector<std::uint64_t> stack;
+
+            for (;;) {
+                if (stack.empty() && !take(t, stack)) {
+                    if (pending.load(std::memory_order_acquire) == 0) return;
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                const std::uint64_t current = stack.back();
+                stack.pop_back();
+
+                for (std::int64_t offset : neighbourOffsets) {
+                    // Only the exchange that claims a cell changes it (its
+                    // state, and its count on a lazy board), so it fails
+                    // only if another thread took the cell
+                    const std::uint64_t n = current + offset;
+                    std::atomic_ref<std::uint8_t> bits(grid[n].bits);
+                    Cell cell;
+                    cell.bits = bits.load(std::memory_order_relaxed);
+                    if (cell.state() != CellState::Hidden) continue;
+
+                    Cell revealed = cell;
+                    revealed.setState(CellState::Revealed);
+                    if (!cell.isCounted()) {
+                        unsigned int count = 0;
+                        for (std::int64_t around : neighbourOffsets) {
+                            Cell other;
+                            other.bits = std::atomic_ref<std::uint8_t>(grid[n + around].bits).load(std::memory_order_relaxed);
+                            count += other.hasMine();
+                        }
+                        revealed.setAdjacentMines(count);
                     }
+                    if (!bits.compare_exchange_strong(cell.bits, revealed.bits, std::memory_order_relaxed)) continue;
+
+                    for (std::int64_t around : neighbourOffsets)
+                        std::atomic_ref<std::uint8_t>(neighbourCounts[n + around]).fetch_sub(16, std::memory_order_relaxed);
+                    ++self.count;
+                    if (recording)
+                        self.revealed.push_back(n);
+
+                    if (revealed.adjacentMines() == 0 && !revealed.hasMine()) {
+                        if (openingsLabelled)
+                            std::atomic_ref<std::uint64_t>(openingTouched[openingOf[n] - 1]).fetch_add(1, std::memory_order_relaxed);
+                        pending.fetch_add(1, std::memory_order_relaxed);
+                        stack.push_back(n);
+                    }
+                }
+                pending.fetch_sub(1, std::memory_order_release);
+
+                if (stack.size() >= 2 * shareBatch) {
+                    std::lock_guard<std::mutex> lock(self.lock);
+                    self.shared.insert(self.shared.end(), stack.begin(), stack.begin() + shareBatch);
+                    stack.erase(stack.begin(), stack.begin() + shareBatch);
+                }
+            }
+        });
+
+        // Counters and history as setCellState would have kept them; the
+        // flood never reveals mines, flags or question marks
+        for (Worker& worker : workers) {
+            revealedSafeCount += worker.count;
+            for (std::uint64_t n : worker.revealed) {
+                if (journalling)
+                    journal.record(n, CellState::Hidden, CellState::Revealed);
+                if (changeSink) {
+                    const std::uint64_t y = n / stride - 1, x = n % stride - 1;
+                    changeSink->push_back({ y * width + x, CellState::Revealed });
                 }
             }
         }
     }
 
-    bool Game::reveal(unsigned int x, unsigned int y) {
+    bool Game::beginReveal(unsigned int x, unsigned int y, std::uint64_t budget, ChangeSet* changes) {
+        MoveScope scope(*this, changes);
+        slicedReveal = true;
+        revealBudget = std::max<std::uint64_t>(budget, 1);
+        return revealAt(x, y);
+    }
+
+    void Game::continueReveal(std::uint64_t budget, ChangeSet* changes) {
+        // Taken over here rather than finished by the scope
+        const bool pending = revealPending;
+        revealPending = false;
+
+        MoveScope scope(*this, changes);
+        slicedReveal = pending;
+        revealBudget = std::max<std::uint64_t>(budget, 1);
+        continueFill();
+    }
+
+    bool Game::isRevealPending() const {
+        return revealPending;
+    }
+
+    bool Game::reveal(unsigned int x, unsigned int y, ChangeSet* changes) {
+        MoveScope scope(*this, changes);
+        return revealAt(x, y);
+    }
+
+    bool Game::revealAt(unsigned int x, unsigned int y) {
+        if (x >= width || y >= height) return true; // ignore out of bounds
+
         if (!isInitialized) {
             placeMines(x, y);
         }
 
-        if (x >= size || y >= size) return true; // ignore out of bounds
-        Cell& cell = grid[y][x];
-        if (cell.state == CellState::Revealed || cell.state == CellState::Flagged) return true;
+        // First-click rule: the mine moves to the first free cell in
+        // row-major order, so only two cells' neighbourhoods change. Only a
+        // click that reveals the cell counts; one on a flag does nothing.
+        const std::uint64_t i = index(x, y);
+        const CellState state = grid[i].state();
+        if (relocateFirstMine && revealedSafeCount == 0 && !gameOver && grid[i].hasMine()
+            && (state == CellState::Hidden || state == CellState::Questioned)) {
+            for (unsigned int row = 0; row < height; ++row) {
+                const Cell* first = &grid[index(0, row)];
+                const Cell* free = std::find_if(first, first + width, [](const Cell& cell) { return !cell.hasMine(); });
+                if (free != first + width) {
+                    changeMine(i, false);
+                    changeMine(index(static_cast<unsigned int>(free - first), row), true);
+                    break;
+                }
+            }
+        }
+
+        return revealCell(i);
+    }
+
+    bool Game::revealCell(std::uint64_t i) {
+        const Cell& cell = grid[i];
+        if (cell.state() == CellState::Revealed || cell.state() == CellState::Flagged) return true;
 
         // If it's a mine, game over
-        if (cell.hasMine) {
-            cell.state = CellState::Revealed;
+        if (cell.hasMine()) {
+            setCellState(i, CellState::Revealed);
             gameOver = true;
             return false;
         }
 
         // Flood fill reveal
-        floodFillReveal(x, y);
+        floodFillReveal(i);
         return true;
     }
 
-    void Game::toggleFlag(unsigned int x, unsigned int y) {
-        if (x >= size || y >= size) return;
-        Cell& cell = grid[y][x];
-        if (cell.state == CellState::Hidden) {
-            cell.state = CellState::Flagged;
-        }
-        else if (cell.state == CellState::Flagged) {
-            cell.state = CellState::Questioned;
+    bool Game::chord(unsigned int x, unsigned int y, ChangeSet* changes) {
+        MoveScope scope(*this, changes);
+        if (x >= width || y >= height || !isInitialized || gameOver) return true;
+
+        const std::uint64_t i = index(x, y);
+        const Cell& cell = grid[i];
+        if (cell.state() != CellState::Revealed || cell.hasMine() || cell.adjacentMines() == 0) return true;
+        if (flaggedNeighbours(i) != cell.adjacentMines()) return true;
+
+        // Same as clicking every unflagged neighbour
+        bool safe = true;
+        for (std::int64_t offset : neighbourOffsets) {
+            safe &= revealCell(i + offset);
         }
-        else if (cell.state == CellState::Questioned) {
-            cell.state = CellState::Hidden;
+        return safe;
+    }
+
+    void Game::autoFlag(ChangeSet* changes) {
+        MoveScope scope(*this, changes);
+        if (!isInitialized || gameOver) return;
+
+        // A number whose unrevealed neighbours equal its mine count has a mine
+        // under each of them. Flagging never changes unrevealed counts, so a
+        // single pass finds every saturated number.
+        for (unsigned int y = 0; y < height; ++y) {
+            const std::uint64_t rowStart = index(0, y);
+            for (std::uint64_t i = rowStart; i < rowStart + width; ++i) {
+                const Cell& cell = grid[i];
+                if (cell.state() != CellState::Revealed || cell.hasMine()) continue;
+
+                const unsigned int mines = cell.adjacentMines();
+                if (mines == 0 || hiddenNeighbours(i) != mines || flaggedNeighbours(i) == mines) continue;
+
+                for (std::int64_t offset : neighbourOffsets) {
+                    const CellState state = grid[i + offset].state();
+                    if (state == CellState::Hidden || state == CellState::Questioned)
+                        setCellState(i + offset, CellState::Flagged);
+                }
+            }
         }
     }
 
-    const std::vector<std::vector<Cell>>& Game::getGrid() const {
-        return grid;
+    void Game::toggleFlag(unsigned int x, unsigned int y, ChangeSet* changes) {
+        MoveScope scope(*this, changes);
+        if (x >= width || y >= height) return;
+        const std::uint64_t i = index(x, y);
+        const CellState state = grid[i].state();
+        if (state == CellState::Hidden) {
+            setCellState(i, CellState::Flagged);
+        }
+        else if (state == CellState::Flagged) {
+            setCellState(i, CellState::Questioned);
+        }
+        else if (state == CellState::Questioned) {
+            setCellState(i, CellState::Hidden);
+        }
     }
 
-    bool Game::checkWin() const {
-        unsigned int revealedCount = 0;
-        for (const auto& row : grid) {
-            for (const auto& cell : row) {
-                if (!cell.hasMine && cell.state == CellState::Revealed)
-                    ++revealedCount;
+    void Game::setCellState(std::uint64_t i, CellState state) {
+        Cell& cell = grid[i];
+
+        // Neighbour counters: high nibble unrevealed, low nibble flagged
+        const int hiddenDelta = (state != CellState::Revealed) - (cell.state() != CellState::Revealed);
+        const int flaggedDelta = (state == CellState::Flagged) - (cell.state() == CellState::Flagged);
+        if (hiddenDelta != 0 || flaggedDelta != 0) {
+            const std::uint8_t delta = static_cast<std::uint8_t>(hiddenDelta * 16 + flaggedDelta);
+            for (std::int64_t offset : neighbourOffsets) {
+                neighbourCounts[i + offset] += delta;
             }
         }
+
+        // Revealed cells always carry their count
+        if (state == CellState::Revealed && !cell.isCounted())
+            cell.setAdjacentMines(countAdjacent(i));
+
+        if (openingsLabelled && openingOf[i] != NoOpening)
+            openingTouched[openingOf[i] - 1] += (cell.state() == CellState::Hidden) - (state == CellState::Hidden);
+
+        switch (cell.state()) {
+        case CellState::Revealed:   if (!cell.hasMine()) --revealedSafeCount; break;
+        case CellState::Flagged:    --flagCount; break;
+        case CellState::Questioned: --questionCount; break;
+        default: break;
+        }
+
+        switch (state) {
+        case CellState::Revealed:   if (!cell.hasMine()) ++revealedSafeCount; break;
+        case CellState::Flagged:    ++flagCount; break;
+        case CellState::Questioned: ++questionCount; break;
+        default: break;
+        }
+
+        if (journalling)
+            journal.record(i, cell.state(), state);
+        cell.setState(state);
+
+        if (changeSink) {
+            const std::uint64_t y = i / stride - 1, x = i % stride - 1;
+            changeSink->push_back({ y * width + x, state });
+        }
+    }
+
+    bool Game::undo(ChangeSet* changes) {
+        if (changes)
+            changes->clear();
+        changeSink = changes;
+        finishReveal();
+
+        const MoveJournal::Move* move = journal.undo();
+        if (!move) {
+            changeSink = nullptr;
+            return false;
+        }
+
+        for (auto run = move->runs.rbegin(); run != move->runs.rend(); ++run) {
+            for (std::uint64_t i = run->start; i < run->start + run->length; ++i)
+                setCellState(i, run->before);
+        }
+        changeSink = nullptr;
+
+        gameOver = move->gameOverBefore;
+        return true;
+    }
+
+    bool Game::redo(ChangeSet* changes) {
+        if (changes)
+            changes->clear();
+        changeSink = changes;
+        finishReveal();
+
+        const MoveJournal::Move* move = journal.redo();
+        if (!move) {
+            changeSink = nullptr;
+            return false;
+        }
+
+        for (const MoveJournal::Run& run : move->runs) {
+            for (std::uint64_t i = run.start; i < run.start + run.length; ++i)
+                setCellState(i, run.after);
+        }
+        changeSink = nullptr;
+
+        gameOver = move->gameOverAfter;
+        return true;
+    }
+
+    bool Game::canUndo() const {
+        return journal.canUndo();
+    }
+
+    bool Game::canRedo() const {
+        return journal.canRedo();
+    }
+
+    void Game::setHistoryDepth(std::size_t depth) {
+        journal.setDepth(depth);
+    }
+
+    GridView Game::getGrid() const {
+        return GridView(grid.data() + stride + 1, stride, width, height);
+    }
+
+    std::size_t Game::memoryFootprint() const {
+        return sizeof(Game) + grid.capacity() * sizeof(Cell) + neighbourCounts.capacity()
+            + (fillStack.capacity() + stencil.capacity() + candidates.capacity()) * sizeof(std::uint64_t)
+            + openingOf.capacity() * sizeof(std::uint32_t)
+            + (openingStart.capacity() + openingCells.capacity() + openingTouched.capacity()) * sizeof(std::uint64_t)
+            + journal.memoryFootprint();
+    }
+
+    std::uint64_t Game::getOpeningCount() const {
+        if (!isInitialized) return 0;
+        if (!openingsLabelled)
+            labelOpenings();
+        return openingTouched.size();
+    }
+
+    bool Game::checkWin() const {
         // Win if all non-mine cells are revealed
-        return (revealedCount == (size * size - mineCount));
+        return (revealedSafeCount == (static_cast<std::uint64_t>(width) * height - mineCount));
+    }
+
+    void Game::setRandomGenerator(std::unique_ptr<RandomGenerator> generator) {
+        if (!generator)
+            throw std::invalid_argument("Random generator must not be null.");
+        rng = std::move(generator);
+    }
+
+    std::uint64_t Game::getSeed() const {
+        return seed;
+    }
+
+    void Game::setMineDensity(double density) {
+        if (density < 0.0 || density > 1.0)
+            throw std::invalid_argument("Mine density must be between 0 and 1.");
+        mineDensity = density;
+    }
+
+    double Game::getMineDensity() const {
+        return mineDensity;
+    }
+
+    std::uint64_t Game::getMineCount() const {
+        return mineCount;
+    }
+
+    std::int64_t Game::remainingMines() const {
+        return static_cast<std::int64_t>(mineCount) - static_cast<std::int64_t>(flagCount);
+    }
+
+    void Game::setDebugOutput(bool enabled) {
+        debugOutput = enabled;
+    }
+
+    void Game::setMine(unsigned int x, unsigned int y, bool mine) {
+        if (x >= width || y >= height)
+            throw std::out_of_range("Mine position outside the board.");
+
+        // Nothing is left for the first click to generate. Undo steps
+        // replay cell states, which would not match the edited layout.
+        finishReveal();
+        journal.clear();
+        isInitialized = true;
+        changeMine(index(x, y), mine);
+    }
+
+    void Game::changeMine(std::uint64_t i, bool mine) {
+        Cell& cell = grid[i];
+        if (cell.hasMine() == mine) return;
+
+        cell.setMine(mine);
+        if (mine) ++mineCount;
+        else --mineCount;
+        if (cell.state() == CellState::Revealed) {
+            if (mine) --revealedSafeCount;
+            else ++revealedSafeCount;
+        }
+
+        // Cells not counted yet (sentinels, cells of a lazy board) pick the
+        // change up when they are counted
+        for (std::int64_t offset : neighbourOffsets) {
+            Cell& neighbour = grid[i + offset];
+            if (neighbour.isCounted())
+                neighbour.setAdjacentMines(mine ? neighbour.adjacentMines() + 1 : neighbour.adjacentMines() - 1);
+        }
+
+        // Openings may have split or merged; label them again when needed
+        openingsLabelled = false;
+    }
+
+    void Game::setFirstClickRelocation(bool enabled) {
+        relocateFirstMine = enabled;
+    }
+
+    void Game::setLazyAdjacency(bool enabled) {
+        lazyAdjacency = enabled;
+    }
+
+    bool Game::getLazyAdjacency() const {
+        return lazyAdjacency;
+    }
+
+    unsigned int Game::getAdjacentMines(unsigned int x, unsigned int y) const {
+        if (x >= width || y >= height)
+            throw std::out_of_range("Cell position outside the board.");
+        return adjacentMines(index(x, y));
     }
 
     bool Game::isGameOver() const { 
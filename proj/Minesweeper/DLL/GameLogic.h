@@ -1,68 +1,353 @@
 #pragma once
 #include "API.h"
+#include "BoardBuffer.h"
+#include "Cell.h"
+#include "Journal.h"
+#include "MappedFile.h"
+#include "Random.h"
+#include "Snapshot.h"
+#include "Topology.h"
 
+#include <cstdint>
+#include <memory>
+#include <string>
 #include <vector>
-#include <unordered_set>
+#include <utility>
 
 namespace Minesweeper {
 
-    struct pair_hash {
-        std::size_t operator()(const std::pair<unsigned int, unsigned int>& p) const {
-            return std::hash<unsigned int>()(p.first) ^ (std::hash<unsigned int>()(p.second) << 1);
-        }
+    // A cell changed by an operation: board index (y * width + x) and its new state
+    struct CellChange {
+        std::uint64_t index;
+        CellState state;
     };
 
-    // Possible states of a cell
-    enum class CellState { Hidden, Revealed, Flagged, Questioned }; 
+    // Caller-owned list of changes; operations clear it and then fill it,
+    // so one buffer can be reused for every move
+    using ChangeSet = std::vector<CellChange>;
+
+    // Lightweight read-only 2D view over the board's contiguous cell buffer
+    class GridView {
+    public:
+        GridView(const Cell* origin, std::uint64_t stride, unsigned int width, unsigned int height)
+            : origin(origin), stride(stride), w(width), h(height) {}
+
+        unsigned int width() const { return w; }
+        unsigned int height() const { return h; }
 
-    // Represents a single cell in the grid
-    struct Cell {
-        bool hasMine = false;
-        unsigned int adjacentMines = 0;
-        CellState state = CellState::Hidden;
+        // Pointer to the first cell of row y, so grid[y][x] works as before
+        const Cell* operator[](unsigned int y) const { return origin + y * stride; }
+
+        const Cell& at(unsigned int x, unsigned int y) const { return origin[y * stride + x]; }
+
+    private:
+        const Cell* origin;
+        std::uint64_t stride;
+        unsigned int w, h;
     };
 
     // Main game logic class
     class EXPORT_API Game {
     public:
-        // Initialize a new game with given size
+        // Game always plays on the classic square grid
+        using Topology = Square8;
+
+        Game() = default;
+        ~Game();
+
+        // Initialize a new game with given size. Without a seed one is drawn
+        // from std::random_device; the same seed and first click always give
+        // the same board.
         void initialize(unsigned int size);
+        void initialize(unsigned int width, unsigned int height);
+        void initialize(unsigned int size, Seed seed);
+        void initialize(unsigned int width, unsigned int height, Seed seed);
+
+        // Memory-mapped storage: the board lives in a snapshot-format file
+        // mapped into memory, so cells are paged in and out by the OS and
+        // opening takes constant time however large the board is. The first
+        // overload opens an existing board file (a saved snapshot or one made
+        // by the second overload); the second creates a fresh board at path.
+        // Any other initialize or loadSnapshot call returns to heap storage.
+        void initialize(const std::string& path);
+        void initialize(const std::string& path, unsigned int width, unsigned int height, Seed seed);
+
+        // Writes the counters into a mapped board's header and flushes the
+        // mapping to disk; does nothing for a heap board
+        void sync();
+        bool isMapped() const;
+
+        // Initialize with a fixed mine layout instead of first-click generation
+        void initializeWithMines(unsigned int width, unsigned int height,
+            const std::vector<std::pair<unsigned int, unsigned int>>& mines);
+
+        // Board editing: puts or removes the mine at (x, y). Only the nine
+        // cells around it change, the neighbours' counts by one each. A board
+        // still waiting for its first click keeps the edited layout instead
+        // of generating one. Undo history is cleared.
+        void setMine(unsigned int x, unsigned int y, bool mine);
+
+        // Classic first-click rule for fixed layouts (generated boards keep
+        // the first click clear anyway): a first reveal that hits a mine
+        // moves it to the first free cell from the top left. Off by default.
+        void setFirstClickRelocation(bool enabled);
+
+        // Reveal the cell at (x, y); returns false if a mine was revealed.
+        // If changes is given it receives every cell the move changed.
+        bool reveal(unsigned int x, unsigned int y, ChangeSet* changes = nullptr);
 
-        // Reveal the cell at (x, y); returns false if a mine was revealed
-        bool reveal(unsigned int x, unsigned int y);
+        // Reveal in slices, for boards where one click can open millions of
+        // cells: beginReveal opens at most about budget cells and returns,
+        // and each continueReveal opens about budget more, so the caller can
+        // keep its window responsive in between. beginReveal returns false
+        // if a mine was revealed. The whole reveal is one undo step, and any
+        // other move first finishes a reveal in progress.
+        bool beginReveal(unsigned int x, unsigned int y, std::uint64_t budget, ChangeSet* changes = nullptr);
+        void continueReveal(std::uint64_t budget, ChangeSet* changes = nullptr);
+        bool isRevealPending() const;
 
         // Toggle flag state on the cell at (x, y)
-        void toggleFlag(unsigned int x, unsigned int y);
+        void toggleFlag(unsigned int x, unsigned int y, ChangeSet* changes = nullptr);
+
+        // Chording: if the revealed number at (x, y) has as many flagged
+        // neighbours as adjacent mines, reveal all its other neighbours.
+        // Returns false if a mine was revealed.
+        bool chord(unsigned int x, unsigned int y, ChangeSet* changes = nullptr);
+
+        // Flag every unrevealed neighbour of each number whose unrevealed
+        // neighbours must all be mines, in one pass over the board
+        void autoFlag(ChangeSet* changes = nullptr);
+
+        // Step back or forward through moves; false if there is nothing to
+        // step over. Changed cells are reported like any other move.
+        bool undo(ChangeSet* changes = nullptr);
+        bool redo(ChangeSet* changes = nullptr);
+        bool canUndo() const;
+        bool canRedo() const;
+
+        // Number of moves kept for undo (256 by default, 0 disables history)
+        void setHistoryDepth(std::size_t depth);
 
         // Check for win/lose condition (all non-mine cells revealed)
         bool checkWin() const;
         bool isGameOver() const;
         bool hasEnded() const;
 
-        // Accessors
-        const std::vector<std::vector<Cell>>& getGrid() const;
+        // Replaces the generator used for mine placement (Xoshiro256 by default);
+        // it is reseeded by the next initialize and keys the counter-based
+        // streams the board's bands draw from (see Generation.h)
+        void setRandomGenerator(std::unique_ptr<RandomGenerator> generator);
+
+        // Seed of the current board, for reproducing it later
+        std::uint64_t getSeed() const;
+
+        // Fraction of cells that get a mine on the next generated board;
+        // clamped to the cells left outside the safe zone
+        void setMineDensity(double density);
+        double getMineDensity() const;
+        std::uint64_t getMineCount() const;
+
+        // Mines left to flag (mine count minus placed flags; may go negative)
+        std::int64_t remainingMines() const;
+
+        // Openings on the board: connected regions of cells with no adjacent
+        // mines, each revealed whole by one click. 0 before the first click.
+        std::uint64_t getOpeningCount() const;
+
+        // Lazy adjacency: boards generated while this is on skip the pass
+        // that counts every cell's adjacent mines, and each count is filled
+        // in when its cell is revealed. A first click on a huge board then
+        // costs the area it opens, not the whole board. Off by default.
+        void setLazyAdjacency(bool enabled);
+        bool getLazyAdjacency() const;
+
+        // Adjacent mines of the cell at (x, y); counted on the spot for a
+        // hidden cell of a lazy board, whose grid entry holds no count yet
+        unsigned int getAdjacentMines(unsigned int x, unsigned int y) const;
+
+        // Print each generated minefield to std::cout (on by default; boards
+        // over 256x256 cells are never printed)
+        void setDebugOutput(bool enabled);
+
+        // Binary snapshot of the whole game: a versioned header, the packed
+        // cell buffer and a checksum. Buffers are copied as a whole, with no
+        // per-cell formatting. Loading throws std::runtime_error on data that
+        // is truncated, corrupt or from an unknown version. Undo history is
+        // not included, and a sliced reveal is saved as far as it has got.
+        void saveSnapshot(std::vector<std::uint8_t>& out) const;
+        void saveSnapshot(const std::string& path) const;
+        void loadSnapshot(const std::uint8_t* data, std::size_t size);
+        void loadSnapshot(const std::string& path);
+
+        // Accessors. On a lazy board hidden cells may not hold their count
+        // yet; getAdjacentMines gives it for any cell.
+        GridView getGrid() const;
+
+        // Heap bytes used by the game object and its cell buffer (the cells
+        // of a mapped board are not counted)
+        std::size_t memoryFootprint() const;
 
     private:
-        std::vector<std::vector<Cell>> grid;  // 2D grid of cells
-        unsigned int size = 0, safeParam = 2;
-        unsigned int mineCount = 0;
+        // Row-major cells surrounded by a one-cell sentinel ring
+        // (revealed, mine-free), so neighbour loops need no bounds checks
+        BoardBuffer<Cell> grid;
+        unsigned int width = 0, height = 0, safeParam = 2;
+        double mineDensity = 0.175;
+        std::unique_ptr<RandomGenerator> rng = std::make_unique<Xoshiro256>();
+        std::uint64_t seed = 0;
+        std::uint64_t stride = 0;
+        std::uint64_t mineCount = 0;
+        // Running totals kept by setCellState, so win checks are O(1)
+        std::uint64_t revealedSafeCount = 0, flagCount = 0, questionCount = 0;
+        std::int64_t neighbourOffsets[8] = {};
+        // Per cell: unrevealed neighbours in the high nibble, flagged
+        // neighbours in the low nibble; maintained by setCellState
+        BoardBuffer<std::uint8_t> neighbourCounts;
+        std::vector<std::uint64_t> fillStack;  // work buffer reused by floodFillReveal
+        std::uint64_t revealBudget = 0;        // cells the current slice may still open
+        bool slicedReveal = false;             // true while beginReveal or continueReveal runs
+        bool revealPending = false;            // fillStack holds the rest of a sliced reveal
+        std::vector<std::uint64_t> stencil;    // one bit per buffer cell closed to mines
+        std::vector<std::uint64_t> candidates; // allowed mine positions, reused by placeMines
+
+        // Openings, labelled once the mines are known (see labelOpenings).
+        // A cache over the cells, so const members may fill it in.
+        static constexpr std::uint32_t NoOpening = 0;
+        static constexpr std::uint32_t SentinelOpening = ~std::uint32_t(0);
+        mutable std::vector<std::uint32_t> openingOf;      // per buffer cell: opening + 1 for zero cells
+        mutable std::vector<std::uint64_t> openingStart;   // opening k is openingCells[openingStart[k], openingStart[k + 1])
+        mutable std::vector<std::uint64_t> openingCells;   // zero cells and numbered border, by index
+        mutable std::vector<std::uint64_t> openingTouched; // zero cells of each opening that are not hidden
+        mutable bool openingsLabelled = false;
         bool isInitialized = false;
         bool gameOver = false;
+        bool debugOutput = true;
+        bool lazyAdjacency = false;
+        bool relocateFirstMine = false;
+        ChangeSet* changeSink = nullptr;  // change set of the operation in progress
+        MoveJournal journal;
+        bool journalling = false;  // true while a public move is recording into the journal
 
-        
         std::pair<unsigned int, unsigned int> firstClickPos;
 
-        // Recursively reveal neighbors if safe
-        void floodFillReveal(unsigned int x, unsigned int y);
+        struct MoveScope;
 
-        // Counts mines adjacent to (x, y)
-        unsigned int countAdjacent(unsigned int x, unsigned int y) const;
+        MappedFile mapping;                      // backing file of a mapped board
+        SnapshotHeader* mappedHeader = nullptr;  // header inside the mapping, or null
+        std::string mappedPath;                  // path the mapping was opened with
 
-        // Generates Safe Zone based on first click position
-        std::unordered_set<std::pair<unsigned int, unsigned int>, pair_hash>
-            generateSafeZone(unsigned int startX, unsigned int startY, unsigned int count) const;
+        // Snapshot helpers shared by the buffer, file and mapped variants;
+        // the payload checksum is skipped when not wanted
+        SnapshotHeader makeSnapshotHeader(bool withChecksum = true) const;
+        void applySnapshotHeader(const SnapshotHeader& header);
+
+        // Points both buffers (cells each) at the payload of the open mapping
+        void attachMapping(std::uint64_t cells);
+
+        // Stores the counters in the mapped header, then unmaps the board
+        // and leaves an empty 0x0 game
+        void closeMapping();
+
+        // Fills freshly sized buffers with an empty board and resets the state
+        void resetBoard(Seed seedValue);
+
+        // Sets width, height, stride and the neighbour offsets
+        void setDimensions(unsigned int width, unsigned int height);
+
+        // Buffer index of the interior cell (x, y)
+        std::uint64_t index(unsigned int x, unsigned int y) const {
+            return (static_cast<std::uint64_t>(y) + 1) * stride + x + 1;
+        }
+
+        // True if buffer index i is a board cell rather than a sentinel
+        bool isInterior(std::uint64_t i) const {
+            return i % stride - 1 < width && i / stride - 1 < height;
+        }
+
+        void markStencil(std::uint64_t i) { stencil[i / 64] |= std::uint64_t(1) << (i % 64); }
+        bool testStencil(std::uint64_t i) const { return (stencil[i / 64] >> (i % 64)) & 1; }
+
+        unsigned int hiddenNeighbours(std::uint64_t i) const { return neighbourCounts[i] >> 4; }
+        unsigned int flaggedNeighbours(std::uint64_t i) const { return neighbourCounts[i] & 0x0F; }
+
+        // Reveal logic shared by reveal and beginReveal: generates the board
+        // on the first click, then reveals the cell
+        bool revealAt(unsigned int x, unsigned int y);
+
+        // Reveal logic shared by reveal and chord, for an initialized board
+        bool revealCell(std::uint64_t i);
+
+        // Changes the state of the cell at buffer index i, keeps the counters
+        // in step and records the change
+        void setCellState(std::uint64_t i, CellState state);
+
+        // Reveal the cell and, if it has no adjacent mines, its whole zero region
+        void floodFillReveal(std::uint64_t i);
+
+        // Opens cells from the zero cells in fillStack until the stack is
+        // empty or revealBudget runs out
+        void continueFill();
+
+        // Finishes a sliced reveal in progress and commits it as its own
+        // undo step; does nothing if there is none
+        void finishReveal();
+
+        // Boards up to this many cells label their openings as soon as
+        // they are played; larger and mapped ones only when getOpeningCount
+        // asks, as the labels take four bytes per cell and a full pass
+        static constexpr std::uint64_t LabelCells = std::uint64_t(1) << 24;
+
+        // Labels every opening in one linear pass and lists its zero cells
+        // and numbered border. A click on a zero cell of an opening whose
+        // zero cells are all still hidden then reveals that list, with no
+        // neighbour search; any other opening goes through the flood fill.
+        void labelOpenings() const;
+
+        // A flood fill that has expanded this many zero cells on one thread
+        // hands the rest of the region to parallelFloodFill
+        static constexpr std::uint64_t ParallelRevealCells = std::uint64_t(1) << 16;
+
+        // Finishes a flood fill from the zero cells left in fillStack on
+        // every core: threads claim cells with an atomic compare-exchange on
+        // the cell byte and steal work from each other's queues. Reveals the
+        // same cells, with the same counters, as the serial fill.
+        void parallelFloodFill();
+
+        // Counts mines adjacent to the cell at buffer index i
+        unsigned int countAdjacent(std::uint64_t i) const;
+
+        // Puts or removes the mine at buffer index i, moving the counters
+        // and the counts of the neighbours that hold one
+        void changeMine(std::uint64_t i, bool mine);
+
+        // Adjacent mines of the interior cell i, from the cell if it has
+        // been counted and from its neighbours otherwise
+        unsigned int adjacentMines(std::uint64_t i) const {
+            return grid[i].isCounted() ? grid[i].adjacentMines() : countAdjacent(i);
+        }
+
+        // Generates Safe Zone based on first click position and marks it in the stencil
+        std::vector<std::uint64_t> generateSafeZone(unsigned int startX, unsigned int startY, unsigned int count);
 
         // Place mines based on the Safe Zone
         void placeMines(unsigned int safeX, unsigned int safeY);
+
+        // Collects the allowed cells of one band of rows into pool and puts
+        // quota mines among them (see Generation.h)
+        void drawBand(std::size_t band, RandomGenerator& generator, std::uint64_t quota, std::vector<std::uint64_t>& pool);
+
+        // Fills in adjacentMines for every cell; lazy boards skip it
+        void computeAdjacency();
+
+        // Boards with at least this many cells are set up on several threads
+        static constexpr std::uint64_t ParallelCells = std::uint64_t(1) << 18;
+
+        // Calls fn(band) for every band of Generation::BandRows rows, in
+        // parallel on large boards. Even bands run before odd ones, so bands
+        // running together are a band apart: fn may read the rows next to
+        // its band while writing its own, and no cache line is written by
+        // two threads.
+        template <typename Fn>
+        void forEachBand(Fn&& fn);
     };
-}
\ No newline at end of file
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Random.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace Minesweeper {
+
+    // Banded mine placement, shared by Game, TiledGame, BasicGame and
+    // SparseGame so the same seed and first click give the same board in
+    // each of them. A board is cut into bands of BandRows rows. Each band
+    // gets a share of the mines in proportion to its allowed cells and
+    // draws them from its own stream of a counter-based generator, keyed by
+    // one number taken from the board's generator. A band's mines depend
+    // only on that key, its index and its quota, so any band can be drawn
+    // again on its own, and the board comes out the same whatever order,
+    // or however many threads, the bands are drawn in.
+    namespace Generation {
+
+        constexpr unsigned int BandRows = 64;
+
+        constexpr std::size_t bandCount(unsigned int height) {
+            return (static_cast<std::size_t>(height) + BandRows - 1) / BandRows;
+        }
+
+        // Generator for the mines of one band
+        inline Philox4x32 bandGenerator(std::uint64_t boardKey, std::size_t band) {
+            return Philox4x32(boardKey, band);
+        }
+
+        // Splits mines (at most the sum of allowed) across bands in
+        // proportion to each band's allowed cells
+        inline void bandQuotas(const std::uint64_t* allowed, std::uint64_t* quotas, std::size_t bands, std::uint64_t mines) {
+            std::uint64_t total = 0;
+            for (std::size_t b = 0; b < bands; ++b)
+                total += allowed[b];
+
+            std::uint64_t assigned = 0;
+            for (std::size_t b = 0; b < bands; ++b) {
+                const double share = total ? static_cast<double>(mines) * static_cast<double>(allowed[b]) / static_cast<double>(total) : 0.0;
+                quotas[b] = std::min(allowed[b], static_cast<std::uint64_t>(share));
+                assigned += quotas[b];
+            }
+
+            // Rounding leaves a few mines over (or, rarely, one too many per
+            // band): settle them one per band from the top
+            for (std::size_t b = 0; assigned < mines; b = (b + 1) % bands) {
+                if (quotas[b] < allowed[b]) { ++quotas[b]; ++assigned; }
+            }
+            for (std::size_t b = 0; assigned > mines; b = (b + 1) % bands) {
+                if (quotas[b] > 0) { --quotas[b]; --assigned; }
+            }
+        }
+    }
+}
@@ -0,0 +1,88 @@
+#include "Journal.h"
+#include <algorithm>
+#include <limits>
+
+namespace Minesweeper {
+
+    void MoveJournal::setDepth(std::size_t d) {
+        depth = d;
+        while (done.size() > depth)
+            done.pop_front();
+        if (depth == 0) {
+            pending.clear();
+            undone.clear();
+        }
+    }
+
+    std::size_t MoveJournal::getDepth() const {
+        return depth;
+    }
+
+    void MoveJournal::clear() {
+        pending.clear();
+        done.clear();
+        undone.clear();
+    }
+
+    void MoveJournal::commit(bool gameOverBefore, bool gameOverAfter) {
+        if (pending.empty()) return;
+
+        std::sort(pending.begin(), pending.end(),
+            [](const Change& a, const Change& b) { return a.index < b.index; });
+
+        Move move;
+        move.gameOverBefore = gameOverBefore;
+        move.gameOverAfter = gameOverAfter;
+
+        for (const Change& change : pending) {
+            if (!move.runs.empty()) {
+                Run& last = move.runs.back();
+                if (last.start + last.length == change.index && last.before == change.before
+                    && last.after == change.after && last.length < std::numeric_limits<std::uint32_t>::max()) {
+                    ++last.length;
+                    continue;
+                }
+            }
+            move.runs.push_back({ change.index, 1, change.before, change.after });
+        }
+        move.runs.shrink_to_fit();
+        pending.clear();
+
+        done.push_back(std::move(move));
+        if (done.size() > depth)
+            done.pop_front();
+        undone.clear();
+    }
+
+    const MoveJournal::Move* MoveJournal::undo() {
+        if (done.empty()) return nullptr;
+        undone.push_back(std::move(done.back()));
+        done.pop_back();
+        return &undone.back();
+    }
+
+    const MoveJournal::Move* MoveJournal::redo() {
+        if (undone.empty()) return nullptr;
+        done.push_back(std::move(undone.back()));
+        undone.pop_back();
+        return &done.back();
+    }
+
+    bool MoveJournal::canUndo() const {
+        return !done.empty();
+    }
+
+    bool MoveJournal::canRedo() const {
+        return !undone.empty();
+    }
+
+    std::size_t MoveJournal::memoryFootprint() const {
+        std::size_t runs = 0;
+        for (const Move& move : done)
+            runs += move.runs.capacity();
+        for (const Move& move : undone)
+            runs += move.runs.capacity();
+        return runs * sizeof(Run) + (done.size() + undone.capacity()) * sizeof(Move)
+            + pending.capacity() * sizeof(Change);
+    }
+}
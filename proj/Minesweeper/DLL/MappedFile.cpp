@@ -0,0 +1,163 @@
+#include "MappedFile.h"
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Minesweeper {
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept {
+        *this = std::move(other);
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            close();
+            base = std::exchange(other.base, nullptr);
+            length = std::exchange(other.length, 0);
+#ifdef _WIN32
+            file = std::exchange(other.file, nullptr);
+            mapping = std::exchange(other.mapping, nullptr);
+#else
+            fd = std::exchange(other.fd, -1);
+#endif
+        }
+        return *this;
+    }
+
+    MappedFile::~MappedFile() {
+        close();
+    }
+
+    void MappedFile::open(const std::string& path) {
+        map(path, 0, false);
+    }
+
+    void MappedFile::create(const std::string& path, std::uint64_t size) {
+        if (size == 0)
+            throw std::invalid_argument("Mapped file size must be positive.");
+        map(path, size, true);
+    }
+
+#ifdef _WIN32
+
+    void MappedFile::map(const std::string& path, std::uint64_t size, bool create) {
+        close();
+
+        HANDLE f = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+            create ? CREATE_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (f == INVALID_HANDLE_VALUE)
+            throw std::runtime_error("Failed to open file for mapping.");
+
+        if (!create) {
+            LARGE_INTEGER fileSize;
+            if (!GetFileSizeEx(f, &fileSize) || fileSize.QuadPart == 0) {
+                CloseHandle(f);
+                throw std::runtime_error("Cannot map an empty file.");
+            }
+            size = static_cast<std::uint64_t>(fileSize.QuadPart);
+        }
+
+        // With an explicit size the mapping also grows a new file to it
+        HANDLE m = CreateFileMappingA(f, nullptr, PAGE_READWRITE,
+            static_cast<DWORD>(size >> 32), static_cast<DWORD>(size & 0xFFFFFFFFu), nullptr);
+        if (!m) {
+            CloseHandle(f);
+            throw std::runtime_error("Failed to create file mapping.");
+        }
+
+        void* view = MapViewOfFile(m, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+        if (!view) {
+            CloseHandle(m);
+            CloseHandle(f);
+            throw std::runtime_error("Failed to map file.");
+        }
+
+        file = f;
+        mapping = m;
+        base = view;
+        length = size;
+    }
+
+    bool MappedFile::flush() {
+        if (!base)
+            return true;
+        return FlushViewOfFile(base, 0) && FlushFileBuffers(file);
+    }
+
+    void MappedFile::close() {
+        if (base)
+            UnmapViewOfFile(base);
+        if (mapping)
+            CloseHandle(mapping);
+        if (file)
+            CloseHandle(file);
+        base = nullptr;
+        mapping = nullptr;
+        file = nullptr;
+        length = 0;
+    }
+
+#else
+
+    void MappedFile::map(const std::string& path, std::uint64_t size, bool create) {
+        close();
+
+        int f = ::open(path.c_str(), create ? O_RDWR | O_CREAT | O_TRUNC : O_RDWR, 0644);
+        if (f < 0)
+            throw std::runtime_error("Failed to open file for mapping.");
+
+        if (create) {
+            if (ftruncate(f, static_cast<off_t>(size)) != 0) {
+                ::close(f);
+                throw std::runtime_error("Failed to size mapped file.");
+            }
+        }
+        else {
+            struct stat info;
+            if (fstat(f, &info) != 0 || info.st_size == 0) {
+                ::close(f);
+                throw std::runtime_error("Cannot map an empty file.");
+            }
+            size = static_cast<std::uint64_t>(info.st_size);
+        }
+
+        void* view = mmap(nullptr, static_cast<std::size_t>(size), PROT_READ | PROT_WRITE, MAP_SHARED, f, 0);
+        if (view == MAP_FAILED) {
+            ::close(f);
+            throw std::runtime_error("Failed to map file.");
+        }
+
+        fd = f;
+        base = view;
+        length = size;
+    }
+
+    bool MappedFile::flush() {
+        if (!base)
+            return true;
+        return msync(base, static_cast<std::size_t>(length), MS_SYNC) == 0;
+    }
+
+    void MappedFile::close() {
+        if (base)
+            munmap(base, static_cast<std::size_t>(length));
+        if (fd >= 0)
+            ::close(fd);
+        base = nullptr;
+        fd = -1;
+        length = 0;
+    }
+
+#endif
+
+} // namespace Minesweeper
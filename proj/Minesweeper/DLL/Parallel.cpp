@@ -0,0 +1,64 @@
+#include "Parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace Minesweeper {
+
+    void parallelFor(std::size_t count, const std::function<void(std::size_t)>& task) {
+        const std::size_t threads = std::min(count, hardwareThreads());
+        if (threads <= 1) {
+            for (std::size_t i = 0; i < count; ++i)
+                task(i);
+            return;
+        }
+
+        std::atomic<std::size_t> next{ 0 };
+        std::exception_ptr error;
+        std::mutex errorMutex;
+
+        auto work = [&] {
+            for (;;) {
+                const std::size_t i = next.fetch_add(1, std::memory_order_relaxed);
+                if (i >= count) return;
+                try {
+                    task(i);
+                }
+                catch (...) {
+                    std::lock_guard<std::mutex> lock(errorMutex);
+                    if (!error)
+                        error = std::current_exception();
+                    next.store(count, std::memory_order_relaxed);
+                }
+            }
+        };
+
+        std::vector<std::thread> workers;
+        workers.reserve(threads - 1);
+        for (std::size_t t = 1; t < threads; ++t) {
+            try {
+                workers.emplace_back(work);
+            }
+            catch (const std::system_error&) {
+                break;  // Out of threads: the ones started, and this one, do the rest
+            }
+        }
+
+        work();
+        for (std::thread& worker : workers)
+            worker.join();
+
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+    std::size_t hardwareThreads() {
+        static const std::size_t threads = std::max(1u, std::thread::hardware_concurrency());
+        return threads;
+    }
+
+} // namespace Minesweeper
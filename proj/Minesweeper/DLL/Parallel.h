@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace Minesweeper {
+
+    // Runs task(i) for every i in [0, count) on up to one thread per core,
+    // the calling thread included, and returns once all are done. Tasks are
+    // handed out one at a time, so uneven tasks still balance. The first
+    // exception a task throws is rethrown here; tasks not started by then
+    // are skipped.
+    // Threads are started per call rather than kept in a pool: a pool owned
+    // by the DLL would have to be joined while it unloads, under the loader
+    // lock. Callers only go parallel for work large enough to hide that.
+    void parallelFor(std::size_t count, const std::function<void(std::size_t)>& task);
+
+    // Threads parallelFor runs on: one per core, at least one
+    std::size_t hardwareThreads();
+}
@@ -0,0 +1,260 @@
+#include "GameLogic.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+namespace Minesweeper {
+
+    namespace {
+
+        // Word-at-a-time mixing checksum; fast enough to run over the whole
+        // payload on every save and load
+        std::uint64_t checksum(const std::uint8_t* data, std::size_t size, std::uint64_t h) {
+            std::size_t i = 0;
+            for (; i + 8 <= size; i += 8) {
+                std::uint64_t word;
+                std::memcpy(&word, data + i, 8);
+                h = (h ^ word) * 0x9E3779B97F4A7C15ull;
+                h ^= h >> 29;
+            }
+            for (; i < size; ++i) {
+                h = (h ^ data[i]) * 0x100000001B3ull;
+            }
+            return h;
+        }
+
+    }
+
+    std::uint64_t snapshotChecksum(const std::uint8_t* cells, const std::uint8_t* counts, std::size_t bufferSize) {
+        return checksum(counts, bufferSize, checksum(cells, bufferSize, 0xCBF29CE484222325ull));
+    }
+
+    SnapshotHeader Game::makeSnapshotHeader(bool withChecksum) const {
+        SnapshotHeader header = {};
+        std::memcpy(header.magic, SnapshotHeader::Magic, sizeof(header.magic));
+        header.version = SnapshotHeader::CurrentVersion;
+        header.width = width;
+        header.height = height;
+        header.firstClickX = firstClickPos.first;
+        header.firstClickY = firstClickPos.second;
+        header.seed = seed;
+        header.mineCount = mineCount;
+        header.revealedSafeCount = revealedSafeCount;
+        header.flagCount = flagCount;
+        header.questionCount = questionCount;
+        header.flags = (isInitialized ? SnapshotHeader::MinesPlaced : 0) | (gameOver ? SnapshotHeader::GameOver : 0);
+        header.mineDensity = mineDensity;
+        header.payloadSize = grid.size() + neighbourCounts.size();
+        if (withChecksum) {
+            header.checksum = snapshotChecksum(reinterpret_cast<const std::uint8_t*>(grid.data()),
+                neighbourCounts.data(), grid.size());
+        }
+        return header;
+    }
+
+    void Game::applySnapshotHeader(const SnapshotHeader& header) {
+        setDimensions(header.width, header.height);
+        firstClickPos = { header.firstClickX, header.firstClickY };
+        seed = header.seed;
+        rng->seed(seed);
+        mineCount = header.mineCount;
+        revealedSafeCount = header.revealedSafeCount;
+        flagCount = header.flagCount;
+        questionCount = header.questionCount;
+        isInitialized = (header.flags & SnapshotHeader::MinesPlaced) != 0;
+        gameOver = (header.flags & SnapshotHeader::GameOver) != 0;
+        mineDensity = header.mineDensity;
+        openingsLabelled = false;
+        fillStack.clear();
+        revealPending = false;
+        journal.clear();
+    }
+
+    void Game::saveSnapshot(std::vector<std::uint8_t>& out) const {
+        const SnapshotHeader header = makeSnapshotHeader();
+        out.resize(sizeof(header) + header.payloadSize);
+
+        std::uint8_t* dst = out.data();
+        std::memcpy(dst, &header, sizeof(header));
+        std::memcpy(dst + sizeof(header), grid.data(), grid.size());
+        std::memcpy(dst + sizeof(header) + grid.size(), neighbourCounts.data(), neighbourCounts.size());
+    }
+
+    void Game::saveSnapshot(const std::string& path) const {
+        const SnapshotHeader header = makeSnapshotHeader();
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file)
+            throw std::runtime_error("Failed to open snapshot file for writing.");
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(grid.data()), static_cast<std::streamsize>(grid.size()));
+        file.write(reinterpret_cast<const char*>(neighbourCounts.data()), static_cast<std::streamsize>(neighbourCounts.size()));
+
+        if (!file)
+            throw std::runtime_error("Failed to write snapshot file.");
+    }
+
+    void Game::loadSnapshot(const std::uint8_t* data, std::size_t size) {
+        SnapshotHeader header;
+        if (size < sizeof(header))
+            throw std::runtime_error("Snapshot is truncated.");
+        std::memcpy(&header, data, sizeof(header));
+
+        const std::uint64_t cells = header.validate(Topology::Kind);
+        if (size - sizeof(header) < header.payloadSize)
+            throw std::runtime_error("Snapshot is truncated.");
+
+        const std::uint8_t* payload = data + sizeof(header);
+        if (!(header.flags & SnapshotHeader::Mapped) && snapshotChecksum(payload, payload + cells, cells) != header.checksum)
+            throw std::runtime_error("Snapshot checksum mismatch.");
+
+        closeMapping();
+        grid.resize(cells);
+        neighbourCounts.resize(cells);
+        std::memcpy(grid.data(), payload, cells);
+        std::memcpy(neighbourCounts.data(), payload + cells, cells);
+        applySnapshotHeader(header);
+    }
+
+    void Game::loadSnapshot(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+            throw std::runtime_error("Failed to open snapshot file.");
+
+        SnapshotHeader header;
+        if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+            throw std::runtime_error("Snapshot is truncated.");
+
+        // Read straight into fresh buffers and only swap them in once the
+        // checksum matches, so a bad file leaves the current game untouched
+        const std::uint64_t cells = header.validate(Topology::Kind);
+        std::vector<Cell> loadedGrid(cells);
+        std::vector<std::uint8_t> loadedCounts(cells);
+        file.read(reinterpret_cast<char*>(loadedGrid.data()), static_cast<std::streamsize>(cells));
+        file.read(reinterpret_cast<char*>(loadedCounts.data()), static_cast<std::streamsize>(cells));
+        if (!file)
+            throw std::runtime_error("Snapshot is truncated.");
+
+        if (!(header.flags & SnapshotHeader::Mapped)
+            && snapshotChecksum(reinterpret_cast<const std::uint8_t*>(loadedGrid.data()), loadedCounts.data(), cells) != header.checksum)
+            throw std::runtime_error("Snapshot checksum mismatch.");
+
+        closeMapping();
+        grid.swap(loadedGrid);
+        neighbourCounts.swap(loadedCounts);
+        applySnapshotHeader(header);
+    }
+
+    void Game::initialize(const std::string& path) {
+        // Reopening the board that is mapped now: the open mapping would
+        // keep the file from being opened again on Windows, so let go of it
+        // first; closing stores the latest counters for the header read below
+        std::error_code error;
+        if (mappedHeader && std::filesystem::equivalent(path, mappedPath, error))
+            closeMapping();
+
+        // Map into a local first, so a bad file leaves any other current
+        // game untouched
+        MappedFile file;
+        file.open(path);
+
+        SnapshotHeader header;
+        if (file.size() < sizeof(header))
+            throw std::runtime_error("Snapshot is truncated.");
+        std::memcpy(&header, file.data(), sizeof(header));
+
+        // No checksum pass here: opening must not touch every page
+        const std::uint64_t cells = header.validate(Topology::Kind);
+        if (file.size() - sizeof(header) < header.payloadSize)
+            throw std::runtime_error("Snapshot is truncated.");
+
+        closeMapping();
+        mapping = std::move(file);
+        mappedPath = path;
+        attachMapping(cells);
+        applySnapshotHeader(header);
+
+        // From here on the payload changes in place and the checksum goes stale
+        mappedHeader->flags |= SnapshotHeader::Mapped;
+        mappedHeader->checksum = 0;
+    }
+
+    void Game::initialize(const std::string& path, unsigned int w, unsigned int h, Seed seedValue) {
+        const std::uint64_t cells = (static_cast<std::uint64_t>(w) + 2) * (static_cast<std::uint64_t>(h) + 2);
+
+        // Recreating the board that is mapped now: the open mapping would
+        // keep the file from being created on Windows, and truncating it on
+        // POSIX would zero the live board, so let go of it first
+        std::error_code error;
+        if (mappedHeader && std::filesystem::equivalent(path, mappedPath, error))
+            closeMapping();
+
+        MappedFile file;
+        file.create(path, sizeof(SnapshotHeader) + 2 * cells);
+
+        closeMapping();
+        setDimensions(w, h);
+        mapping = std::move(file);
+        mappedPath = path;
+        attachMapping(cells);
+        resetBoard(seedValue);
+        sync();
+    }
+
+    void Game::attachMapping(std::uint64_t cells) {
+        std::uint8_t* base = static_cast<std::uint8_t*>(mapping.data());
+
+        mappedHeader = reinterpret_cast<SnapshotHeader*>(base);
+        grid.attach(reinterpret_cast<Cell*>(base + sizeof(SnapshotHeader)), cells);
+        neighbourCounts.attach(base + sizeof(SnapshotHeader) + cells, cells);
+    }
+
+    void Game::sync() {
+        if (!mappedHeader)
+            return;
+
+        SnapshotHeader header = makeSnapshotHeader(false);
+        header.flags |= SnapshotHeader::Mapped;
+        *mappedHeader = header;
+        if (!mapping.flush())
+            throw std::runtime_error("Failed to flush mapped board.");
+    }
+
+    bool Game::isMapped() const {
+        return mappedHeader != nullptr;
+    }
+
+    void Game::closeMapping() {
+        if (!mappedHeader)
+            return;
+
+        // Unmapping writes the dirty pages back, so no flush is needed here
+        SnapshotHeader header = makeSnapshotHeader(false);
+        header.flags |= SnapshotHeader::Mapped;
+        *mappedHeader = header;
+
+        grid.clear();
+        neighbourCounts.clear();
+        mappedHeader = nullptr;
+        mappedPath.clear();
+        mapping.close();
+
+        // Until another board is set up (which may yet fail) the game is an
+        // empty 0x0 board rather than a size over freed cells
+        setDimensions(0, 0);
+        mineCount = 0;
+        revealedSafeCount = 0;
+        flagCount = 0;
+        questionCount = 0;
+        isInitialized = false;
+        gameOver = false;
+        openingsLabelled = false;
+        fillStack.clear();
+        revealPending = false;
+        journal.clear();
+    }
+
+} // namespace Minesweeper
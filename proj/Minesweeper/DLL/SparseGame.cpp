@@ -0,0 +1,527 @@
+#include "SparseGame.h"
+#include "Generation.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+
+namespace Minesweeper {
+
+    namespace {
+
+        std::uint64_t packPos(unsigned int x, unsigned int y) { return (static_cast<std::uint64_t>(y) << 32) | x; }
+    }
+
+    // Points the change sink at the caller's buffer for one move
+    struct SparseGame::MoveScope {
+        SparseGame& game;
+
+        MoveScope(SparseGame& game, ChangeSet* changes) : game(game) {
+            game.changeSink = changes;
+            if (changes)
+                changes->clear();
+        }
+
+        ~MoveScope() {
+            game.changeSink = nullptr;
+        }
+    };
+
+    void SparseGame::TileBitmap::reset(unsigned int w, unsigned int h) {
+        tiles.clear();
+        width = w;
+        height = h;
+        tilesPerRow = (static_cast<std::uint64_t>(width) + 63) / 64;
+    }
+
+    std::uint32_t SparseGame::TileBitmap::tileCells(unsigned int x, unsigned int y) const {
+        const unsigned int columns = std::min(64u, width - (x & ~63u));
+        const unsigned int rows = std::min(64u, height - (y & ~63u));
+        return columns * rows;
+    }
+
+    bool SparseGame::TileBitmap::test(unsigned int x, unsigned int y) const {
+        if (tiles.empty()) return false;  // the usual case for flags and question marks
+        const auto it = tiles.find(tileKey(x, y));
+        if (it == tiles.end()) return false;
+        const Tile& tile = it->second;
+        return tile.rows.empty() || ((tile.rows[y & 63] >> (x & 63)) & 1);
+    }
+
+    void SparseGame::TileBitmap::set(unsigned int x, unsigned int y) {
+        Tile& tile = tiles[tileKey(x, y)];
+        if (tile.count == 0)
+            tile.rows.assign(64, 0);
+        else if (tile.rows.empty())
+            return;  // full
+
+        std::uint64_t& row = tile.rows[y & 63];
+        const std::uint64_t bit = std::uint64_t(1) << (x & 63);
+        if (row & bit) return;
+        row |= bit;
+
+        // A full tile needs no words: every test answers yes
+        if (++tile.count == tileCells(x, y)) {
+            tile.rows.clear();
+            tile.rows.shrink_to_fit();
+        }
+    }
+
+    void SparseGame::TileBitmap::clear(unsigned int x, unsigned int y) {
+        const auto it = tiles.find(tileKey(x, y));
+        if (it == tiles.end()) return;
+        Tile& tile = it->second;
+
+        if (tile.rows.empty()) {
+            // Full tile: spell out its cells on the board again
+            const unsigned int columns = std::min(64u, width - (x & ~63u));
+            const unsigned int rows = std::min(64u, height - (y & ~63u));
+            const std::uint64_t rowBits = columns == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << columns) - 1;
+            tile.rows.assign(64, 0);
+            std::fill_n(tile.rows.begin(), rows, rowBits);
+        }
+
+        std::uint64_t& row = tile.rows[y & 63];
+        const std::uint64_t bit = std::uint64_t(1) << (x & 63);
+        if (!(row & bit)) return;
+        row &= ~bit;
+
+        if (--tile.count == 0)
+            tiles.erase(it);
+    }
+
+    std::size_t SparseGame::TileBitmap::memoryFootprint() const {
+        std::size_t bytes = tiles.bucket_count() * sizeof(void*)
+            + tiles.size() * (sizeof(std::pair<const std::uint64_t, Tile>) + sizeof(void*));
+        for (const auto& [key, tile] : tiles)
+            bytes += tile.rows.capacity() * sizeof(std::uint64_t);
+        return bytes;
+    }
+
+    bool SparseGame::isPreferred(unsigned int w, unsigned int h, double density) {
+        return static_cast<std::uint64_t>(w) * h >= SparseCells && density <= SparseDensity;
+    }
+
+    void SparseGame::initialize(unsigned int w, unsigned int h) {
+        std::random_device rd;
+        initialize(w, h, Seed{ (static_cast<std::uint64_t>(rd()) << 32) ^ rd() });
+    }
+
+    void SparseGame::initialize(unsigned int w, unsigned int h, Seed seedValue) {
+        resetBoard(w, h);
+        seed = seedValue.value;
+        rng.seed(seed);
+    }
+
+    void SparseGame::resetBoard(unsigned int w, unsigned int h) {
+        if (w == 0 || h == 0)
+            throw std::invalid_argument("Board dimensions must be positive.");
+
+        width = w;
+        height = h;
+        mines.clear();
+        rowStart.assign(static_cast<std::size_t>(height) + 1, 0);
+        revealed.reset(width, height);
+        flagged.reset(width, height);
+        questioned.reset(width, height);
+
+        mineCount = 0;
+        revealedSafeCount = 0;
+        flagCount = 0;
+        isInitialized = false;  // Wait for first click
+        gameOver = false;
+    }
+
+    void SparseGame::initializeWithMines(unsigned int w, unsigned int h,
+        const std::vector<std::pair<unsigned int, unsigned int>>& layout) {
+        initialize(w, h, Seed{});
+
+        for (const auto& [x, y] : layout) {
+            if (x >= width || y >= height)
+                throw std::out_of_range("Mine position outside the board.");
+            mines.push_back(static_cast<std::uint64_t>(y) * width + x);
+        }
+        std::sort(mines.begin(), mines.end());
+        mines.erase(std::unique(mines.begin(), mines.end()), mines.end());
+        mineCount = mines.size();
+
+        indexRows();
+        isInitialized = true;
+    }
+
+    void SparseGame::indexRows() {
+        std::fill(rowStart.begin(), rowStart.end(), 0);
+        for (std::uint64_t pos : mines)
+            ++rowStart[pos / width + 1];
+        for (std::size_t y = 0; y < height; ++y)
+            rowStart[y + 1] += rowStart[y];
+    }
+
+    void SparseGame::placeMines(unsigned int safeX, unsigned int safeY) {
+        // 1. Generate safe zone, breadth-first in Game's neighbour order.
+        //    closed lists the row-major cells no mine may take; it holds a
+        //    few dozen cells at most, so it is searched linearly.
+        std::vector<std::uint64_t> closed{ static_cast<std::uint64_t>(safeY) * width + safeX };
+        auto isClosed = [&](std::uint64_t i) { return std::find(closed.begin(), closed.end(), i) != closed.end(); };
+
+        std::vector<std::uint64_t> safeZone{ packPos(safeX, safeY) };
+        for (std::size_t head = 0; head < safeZone.size() && safeZone.size() < safeParam; ++head) {
+            const unsigned int x = static_cast<unsigned int>(safeZone[head]);
+            const unsigned int y = static_cast<unsigned int>(safeZone[head] >> 32);
+            for (int dy = -1; dy <= 1 && safeZone.size() < safeParam; ++dy) {
+                for (int dx = -1; dx <= 1 && safeZone.size() < safeParam; ++dx) {
+                    const unsigned int nx = x + dx, ny = y + dy;
+                    if ((dx == 0 && dy == 0) || nx >= width || ny >= height) continue;
+                    const std::uint64_t n = static_cast<std::uint64_t>(ny) * width + nx;
+                    if (isClosed(n)) continue;
+                    closed.push_back(n);
+                    safeZone.push_back(packPos(nx, ny));
+                }
+            }
+        }
+
+        if (safeZone.size() != safeParam)
+            throw std::runtime_error("Failed to create a safe zone.");
+
+        // 2. Also forbid placing mines around the safe zone
+        for (std::uint64_t pos : safeZone) {
+            const unsigned int x = static_cast<unsigned int>(pos);
+            const unsigned int y = static_cast<unsigned int>(pos >> 32);
+            for (int dy = -1; dy <= 1; ++dy) {
+                for (int dx = -1; dx <= 1; ++dx) {
+                    const unsigned int nx = x + dx, ny = y + dy;
+                    if (nx >= width || ny >= height) continue;
+                    const std::uint64_t n = static_cast<std::uint64_t>(ny) * width + nx;
+                    if (!isClosed(n))
+                        closed.push_back(n);
+                }
+            }
+        }
+        std::sort(closed.begin(), closed.end());
+
+        // 3. Share the mines out between bands as Game does
+        const std::uint64_t cellCount = static_cast<std::uint64_t>(width) * height;
+        const std::uint64_t bandCells = static_cast<std::uint64_t>(Generation::BandRows) * width;
+        const std::size_t bands = Generation::bandCount(height);
+        std::vector<std::uint64_t> allowed(bands), quotas(bands);
+        for (std::size_t band = 0; band < bands; ++band)
+            allowed[band] = std::min(bandCells, cellCount - band * bandCells);
+        for (std::uint64_t i : closed)
+            --allowed[i / bandCells];
+
+        std::uint64_t allowedTotal = 0;
+        for (std::uint64_t count : allowed)
+            allowedTotal += count;
+        const std::uint64_t requested = static_cast<std::uint64_t>(static_cast<double>(width) * height * mineDensity);
+        mineCount = std::min<std::uint64_t>(requested, allowedTotal);
+        Generation::bandQuotas(allowed.data(), quotas.data(), bands, mineCount);
+
+        const std::uint64_t boardKey = rng.next();
+
+        std::vector<std::uint64_t> firstMine(bands + 1, 0);
+        for (std::size_t band = 0; band < bands; ++band)
+            firstMine[band + 1] = firstMine[band] + quotas[band];
+        mines.resize(mineCount);
+
+        // 4. Draw each band's mines with Game's partial Fisher-Yates shuffle,
+        //    over the band's allowed cells without listing them: candidate k
+        //    is the k-th cell of the band that is not closed, and only the
+        //    slots the shuffle has swapped are stored
+        auto drawBand = [&](std::size_t band) {
+            Philox4x32 generator = Generation::bandGenerator(boardKey, band);
+
+            const std::uint64_t first = band * bandCells;
+            const auto closedBegin = std::lower_bound(closed.begin(), closed.end(), first);
+            const auto closedEnd = std::lower_bound(closed.begin(), closed.end(), first + bandCells);
+            auto candidate = [&](std::uint64_t k) {
+                std::uint64_t i = first + k;
+                for (auto c = closedBegin; c != closedEnd && *c <= i; ++c)
+                    ++i;
+                return i;
+            };
+
+            std::unordered_map<std::uint64_t, std::uint64_t> swapped;
+            auto slot = [&](std::uint64_t k) {
+                const auto it = swapped.find(k);
+                return it == swapped.end() ? candidate(k) : it->second;
+            };
+
+            std::uint64_t* out = mines.data() + firstMine[band];
+            for (std::uint64_t k = 0; k < quotas[band]; ++k) {
+                const std::uint64_t j = k + generator.below(allowed[band] - k);
+                const std::uint64_t picked = slot(j), displaced = slot(k);
+                swapped[j] = displaced;
+                swapped.erase(k);  // slot k is never read again
+                out[k] = picked;
+            }
+            std::sort(out, out + quotas[band]);
+        };
+
+        if (bands > 1 && cellCount >= ParallelCells)
+            parallelFor(bands, drawBand);
+        else
+            for (std::size_t band = 0; band < bands; ++band)
+                drawBand(band);
+
+        indexRows();
+
+        // 5. Reveal safe zone
+        for (std::uint64_t pos : safeZone) {
+            floodFillReveal(static_cast<unsigned int>(pos), static_cast<unsigned int>(pos >> 32));
+        }
+
+        isInitialized = true;
+    }
+
+    bool SparseGame::hasMine(unsigned int x, unsigned int y) const {
+        const std::uint64_t pos = static_cast<std::uint64_t>(y) * width + x;
+        return std::binary_search(mines.begin() + rowStart[y], mines.begin() + rowStart[y + 1], pos);
+    }
+
+    unsigned int SparseGame::countAdjacent(unsigned int x, unsigned int y) const {
+        // One search per row for the first mine at or right of x - 1
+        const unsigned int left = x > 0 ? x - 1 : x;
+        const unsigned int right = std::min(x + 1, width - 1);
+        unsigned int count = 0;
+        for (int dy = -1; dy <= 1; ++dy) {
+            const unsigned int ny = y + dy;
+            if (ny >= height) continue;
+            const std::uint64_t rowBase = static_cast<std::uint64_t>(ny) * width;
+            const auto end = mines.begin() + rowStart[ny + 1];
+            for (auto it = std::lower_bound(mines.begin() + rowStart[ny], end, rowBase + left);
+                it != end && *it <= rowBase + right; ++it) {
+                if (dy != 0 || *it != rowBase + x)
+                    ++count;
+            }
+        }
+        return count;
+    }
+
+    CellState SparseGame::stateAt(unsigned int x, unsigned int y) const {
+        if (revealed.test(x, y)) return CellState::Revealed;
+        if (flagged.test(x, y)) return CellState::Flagged;
+        if (questioned.test(x, y)) return CellState::Questioned;
+        return CellState::Hidden;
+    }
+
+    void SparseGame::setCellState(unsigned int x, unsigned int y, CellState state) {
+        switch (stateAt(x, y)) {
+        case CellState::Revealed:   revealed.clear(x, y); if (!hasMine(x, y)) --revealedSafeCount; break;
+        case CellState::Flagged:    flagged.clear(x, y); --flagCount; break;
+        case CellState::Questioned: questioned.clear(x, y); break;
+        default: break;
+        }
+
+        switch (state) {
+        case CellState::Revealed:   revealed.set(x, y); if (!hasMine(x, y)) ++revealedSafeCount; break;
+        case CellState::Flagged:    flagged.set(x, y); ++flagCount; break;
+        case CellState::Questioned: questioned.set(x, y); break;
+        default: break;
+        }
+
+        if (changeSink)
+            changeSink->push_back({ static_cast<std::uint64_t>(y) * width + x, state });
+    }
+
+    bool SparseGame::reveal(unsigned int x, unsigned int y, ChangeSet* changes) {
+        MoveScope scope(*this, changes);
+        if (x >= width || y >= height) return true; // ignore out of bounds
+
+        if (!isInitialized) {
+            placeMines(x, y);
+        }
+
+        return revealCell(x, y);
+    }
+
+    bool SparseGame::revealCell(unsigned int x, unsigned int y) {
+        const CellState state = stateAt(x, y);
+        if (state == CellState::Revealed || state == CellState::Flagged) return true;
+
+        // If it's a mine, game over
+        if (hasMine(x, y)) {
+            setCellState(x, y, CellState::Revealed);
+            gameOver = true;
+            return false;
+        }
+
+        floodFillReveal(x, y);
+        return true;
+    }
+
+    void SparseGame::floodFillReveal(unsigned int x, unsigned int y) {
+        // Base case: already revealed, flagged or questioned
+        if (stateAt(x, y) != CellState::Hidden) return;
+
+        // Reveal this cell
+        setCellState(x, y, CellState::Revealed);
+        if (hasMine(x, y) || countAdjacent(x, y) != 0) return;
+
+        // The fill reveals the hidden zero cells connected to this one and
+        // every hidden neighbour of those, as Game's does. It works in spans:
+        // a seed is widened to the whole run of hidden zero cells in its row,
+        // then the rows above and below are revealed along it and each run
+        // of hidden zero cells there becomes a seed. The stack then holds
+        // runs rather than cells, which on an open board is far fewer.
+        auto isHiddenZero = [&](unsigned int cx, unsigned int cy) {
+            return stateAt(cx, cy) == CellState::Hidden && countAdjacent(cx, cy) == 0;
+        };
+
+        fillStack.clear();
+        fillStack.push_back(packPos(x, y));
+
+        while (!fillStack.empty()) {
+            const std::uint64_t seedPos = fillStack.back();
+            fillStack.pop_back();
+            unsigned int left = static_cast<unsigned int>(seedPos);
+            const unsigned int row = static_cast<unsigned int>(seedPos >> 32);
+
+            // Seeds are left hidden until taken, so a run seeded twice is
+            // skipped the second time; the first seed is already revealed
+            if (stateAt(left, row) == CellState::Hidden) {
+                if (countAdjacent(left, row) != 0) continue;
+                setCellState(left, row, CellState::Revealed);
+            }
+
+            unsigned int right = left;
+            while (left > 0 && isHiddenZero(left - 1, row))
+                setCellState(--left, row, CellState::Revealed);
+            while (right + 1 < width && isHiddenZero(right + 1, row))
+                setCellState(++right, row, CellState::Revealed);
+
+            // Neighbours of the span; zero cells among them are never mines
+            const unsigned int first = left > 0 ? left - 1 : left;
+            const unsigned int last = std::min(right + 1, width - 1);
+            for (int dy = -1; dy <= 1; ++dy) {
+                const unsigned int ny = row + dy;
+                if (ny >= height) continue;
+                bool inRun = false;
+                for (unsigned int nx = first; nx <= last; ++nx) {
+                    if (stateAt(nx, ny) != CellState::Hidden) {
+                        inRun = false;
+                        continue;
+                    }
+                    if (countAdjacent(nx, ny) != 0) {
+                        setCellState(nx, ny, CellState::Revealed);
+                        inRun = false;
+                    }
+                    else if (!inRun) {
+                        fillStack.push_back(packPos(nx, ny));
+                        inRun = true;
+                    }
+                }
+            }
+        }
+    }
+
+    void SparseGame::toggleFlag(unsigned int x, unsigned int y, ChangeSet* changes) {
+        MoveScope scope(*this, changes);
+        if (x >= width || y >= height) return;
+
+        const CellState state = stateAt(x, y);
+        if (state == CellState::Hidden) {
+            setCellState(x, y, CellState::Flagged);
+        }
+        else if (state == CellState::Flagged) {
+            setCellState(x, y, CellState::Questioned);
+        }
+        else if (state == CellState::Questioned) {
+            setCellState(x, y, CellState::Hidden);
+        }
+    }
+
+    bool SparseGame::chord(unsigned int x, unsigned int y, ChangeSet* changes) {
+        MoveScope scope(*this, changes);
+        if (x >= width || y >= height || !isInitialized || gameOver) return true;
+        if (stateAt(x, y) != CellState::Revealed || hasMine(x, y)) return true;
+
+        const unsigned int mines = countAdjacent(x, y);
+        unsigned int flags = 0;
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                const unsigned int nx = x + dx, ny = y + dy;
+                if (nx < width && ny < height && flagged.test(nx, ny))
+                    ++flags;
+            }
+        }
+        if (mines == 0 || flags != mines) return true;
+
+        // Same as clicking every unflagged neighbour
+        bool safe = true;
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                const unsigned int nx = x + dx, ny = y + dy;
+                if ((dx != 0 || dy != 0) && nx < width && ny < height)
+                    safe &= revealCell(nx, ny);
+            }
+        }
+        return safe;
+    }
+
+    unsigned int SparseGame::getAdjacentMines(unsigned int x, unsigned int y) const {
+        if (x >= width || y >= height)
+            throw std::out_of_range("Cell position outside the board.");
+        return countAdjacent(x, y);
+    }
+
+    Cell SparseGame::cellAt(unsigned int x, unsigned int y) const {
+        if (x >= width || y >= height)
+            throw std::out_of_range("Cell position outside the board.");
+
+        Cell cell;
+        cell.setMine(hasMine(x, y));
+        cell.setAdjacentMines(countAdjacent(x, y));
+        cell.setState(stateAt(x, y));
+        return cell;
+    }
+
+    std::size_t SparseGame::memoryFootprint() const {
+        return sizeof(SparseGame)
+            + (mines.capacity() + rowStart.capacity() + fillStack.capacity()) * sizeof(std::uint64_t)
+            + revealed.memoryFootprint() + flagged.memoryFootprint() + questioned.memoryFootprint();
+    }
+
+    bool SparseGame::checkWin() const {
+        // Win if all non-mine cells are revealed
+        return (revealedSafeCount == (static_cast<std::uint64_t>(width) * height - mineCount));
+    }
+
+    bool SparseGame::isGameOver() const {
+        return gameOver;
+    }
+
+    bool SparseGame::hasEnded() const {
+        return gameOver || checkWin();
+    }
+
+    std::uint64_t SparseGame::getSeed() const {
+        return seed;
+    }
+
+    void SparseGame::setMineDensity(double density) {
+        if (density < 0.0 || density > 1.0)
+            throw std::invalid_argument("Mine density must be between 0 and 1.");
+        mineDensity = density;
+    }
+
+    double SparseGame::getMineDensity() const {
+        return mineDensity;
+    }
+
+    std::uint64_t SparseGame::getMineCount() const {
+        return mineCount;
+    }
+
+    std::int64_t SparseGame::remainingMines() const {
+        return static_cast<std::int64_t>(mineCount) - static_cast<std::int64_t>(flagCount);
+    }
+
+    unsigned int SparseGame::getWidth() const {
+        return width;
+    }
+
+    unsigned int SparseGame::getHeight() const {
+        return height;
+    }
+
+} // namespace Minesweeper
@@ -0,0 +1,390 @@
+#include "TiledGame.h"
+#include "Generation.h"
+#include <algorithm>
+#include <bit>
+#include <random>
+#include <stdexcept>
+#include <type_traits>
+
+namespace Minesweeper {
+
+    namespace {
+
+        template <CellLayout L>
+        using LayoutTag = std::integral_constant<CellLayout, L>;
+
+        // Calls f with the layout as a compile-time constant, so the
+        // per-cell index arithmetic inside f needs no branch
+        template <typename F>
+        decltype(auto) withLayout(CellLayout layout, F&& f) {
+            switch (layout) {
+            case CellLayout::Tiles8:  return f(LayoutTag<CellLayout::Tiles8>{});
+            case CellLayout::Tiles16: return f(LayoutTag<CellLayout::Tiles16>{});
+            case CellLayout::ZOrder:  return f(LayoutTag<CellLayout::ZOrder>{});
+            default:                  return f(LayoutTag<CellLayout::RowMajor>{});
+            }
+        }
+
+        // Side of a tile as a power of two
+        constexpr unsigned int tileBits(CellLayout layout) {
+            return layout == CellLayout::Tiles8 ? 3 : 4;
+        }
+
+        // Moves bit k of v to bit 2k, for Morton indices
+        std::uint64_t spreadBits(std::uint32_t v) {
+            std::uint64_t x = v;
+            x = (x | (x << 16)) & 0x0000FFFF0000FFFFull;
+            x = (x | (x << 8)) & 0x00FF00FF00FF00FFull;
+            x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0Full;
+            x = (x | (x << 2)) & 0x3333333333333333ull;
+            x = (x | (x << 1)) & 0x5555555555555555ull;
+            return x;
+        }
+
+        std::uint64_t packPos(unsigned int x, unsigned int y) { return (static_cast<std::uint64_t>(y) << 32) | x; }
+    }
+
+    template <CellLayout L>
+    std::uint64_t TiledGame::cellIndex(unsigned int x, unsigned int y) const {
+        if constexpr (L == CellLayout::RowMajor) {
+            return static_cast<std::uint64_t>(y) * width + x;
+        }
+        else if constexpr (L == CellLayout::ZOrder) {
+            return spreadBits(x) | (spreadBits(y) << 1);
+        }
+        else {
+            constexpr unsigned int bits = tileBits(L);
+            constexpr unsigned int mask = (1u << bits) - 1;
+            const std::uint64_t tile = static_cast<std::uint64_t>(y >> bits) * tilesPerRow + (x >> bits);
+            return (tile << (2 * bits)) | ((y & mask) << bits) | (x & mask);
+        }
+    }
+
+    void TiledGame::initialize(unsigned int w, unsigned int h, CellLayout cellLayout) {
+        std::random_device rd;
+        initialize(w, h, Seed{ (static_cast<std::uint64_t>(rd()) << 32) ^ rd() }, cellLayout);
+    }
+
+    void TiledGame::initialize(unsigned int w, unsigned int h, Seed seedValue, CellLayout cellLayout) {
+        resetBoard(w, h, cellLayout);
+        rng.seed(seedValue.value);
+    }
+
+    void TiledGame::resetBoard(unsigned int w, unsigned int h, CellLayout cellLayout) {
+        if (w == 0 || h == 0)
+            throw std::invalid_argument("Board dimensions must be positive.");
+
+        width = w;
+        height = h;
+        layout = cellLayout;
+
+        std::uint64_t size;
+        if (layout == CellLayout::RowMajor) {
+            size = static_cast<std::uint64_t>(width) * height;
+        }
+        else if (layout == CellLayout::ZOrder) {
+            const std::uint64_t side = std::bit_ceil(static_cast<std::uint64_t>(std::max(width, height)));
+            size = side * side;
+        }
+        else {
+            const unsigned int bits = tileBits(layout);
+            const std::uint64_t side = std::uint64_t(1) << bits;
+            tilesPerRow = (width + side - 1) >> bits;
+            size = tilesPerRow * ((height + side - 1) >> bits) * side * side;
+        }
+        cells.assign(size, Cell{});
+
+        mineCount = 0;
+        revealedSafeCount = 0;
+        flagCount = 0;
+        isInitialized = false;  // Wait for first click
+        gameOver = false;
+    }
+
+    void TiledGame::initializeWithMines(unsigned int w, unsigned int h,
+        const std::vector<std::pair<unsigned int, unsigned int>>& mines, CellLayout cellLayout) {
+        resetBoard(w, h, cellLayout);
+
+        withLayout(layout, [&](auto tag) {
+            constexpr CellLayout L = decltype(tag)::value;
+            for (const auto& [x, y] : mines) {
+                if (x >= width || y >= height)
+                    throw std::out_of_range("Mine position outside the board.");
+                Cell& cell = cells[cellIndex<L>(x, y)];
+                if (!cell.hasMine()) {
+                    cell.setMine(true);
+                    ++mineCount;
+                }
+            }
+            computeAdjacency<L>();
+        });
+        isInitialized = true;
+    }
+
+    template <CellLayout L>
+    void TiledGame::placeMines(unsigned int safeX, unsigned int safeY) {
+        // 1. Generate safe zone, breadth-first in Game's neighbour order; the
+        //    stencil and the candidate list are row-major so the draw below
+        //    matches Game's whatever the layout
+        const std::uint64_t cellCount = static_cast<std::uint64_t>(width) * height;
+        stencil.assign(cellCount / 64 + 1, 0);
+        auto mark = [&](std::uint64_t i) { stencil[i / 64] |= std::uint64_t(1) << (i % 64); };
+        auto marked = [&](std::uint64_t i) { return (stencil[i / 64] >> (i % 64)) & 1; };
+
+        std::vector<std::uint64_t> safeZone{ packPos(safeX, safeY) };
+        mark(static_cast<std::uint64_t>(safeY) * width + safeX);
+        for (std::size_t head = 0; head < safeZone.size() && safeZone.size() < safeParam; ++head) {
+            const unsigned int x = static_cast<unsigned int>(safeZone[head]);
+            const unsigned int y = static_cast<unsigned int>(safeZone[head] >> 32);
+            for (int dy = -1; dy <= 1 && safeZone.size() < safeParam; ++dy) {
+                for (int dx = -1; dx <= 1 && safeZone.size() < safeParam; ++dx) {
+                    const unsigned int nx = x + dx, ny = y + dy;
+                    if ((dx == 0 && dy == 0) || nx >= width || ny >= height) continue;
+                    const std::uint64_t n = static_cast<std::uint64_t>(ny) * width + nx;
+                    if (marked(n)) continue;
+                    mark(n);
+                    safeZone.push_back(packPos(nx, ny));
+                }
+            }
+        }
+
+        if (safeZone.size() != safeParam)
+            throw std::runtime_error("Failed to create a safe zone.");
+
+        // 2. Also forbid placing mines around the safe zone
+        const std::size_t bands = Generation::bandCount(height);
+        std::vector<std::uint64_t> allowed(bands), quotas(bands);
+        for (std::size_t band = 0; band < bands; ++band) {
+            const unsigned int firstRow = static_cast<unsigned int>(band * Generation::BandRows);
+            allowed[band] = static_cast<std::uint64_t>(std::min(height - firstRow, Generation::BandRows)) * width;
+        }
+
+        for (std::uint64_t pos : safeZone)
+            --allowed[(pos >> 32) / Generation::BandRows];
+        for (std::uint64_t pos : safeZone) {
+            const unsigned int x = static_cast<unsigned int>(pos);
+            const unsigned int y = static_cast<unsigned int>(pos >> 32);
+            for (int dy = -1; dy <= 1; ++dy) {
+                for (int dx = -1; dx <= 1; ++dx) {
+                    const unsigned int nx = x + dx, ny = y + dy;
+                    if (nx >= width || ny >= height) continue;
+                    const std::uint64_t n = static_cast<std::uint64_t>(ny) * width + nx;
+                    if (!marked(n)) {
+                        mark(n);
+                        --allowed[ny / Generation::BandRows];
+                    }
+                }
+            }
+        }
+
+        // 3. Share the mines out between bands as Game does, then draw each
+        //    band's with a partial Fisher-Yates shuffle
+        std::uint64_t allowedTotal = 0;
+        for (std::uint64_t count : allowed)
+            allowedTotal += count;
+        const std::uint64_t requested = static_cast<std::uint64_t>(static_cast<double>(width) * height * mineDensity);
+        mineCount = std::min<std::uint64_t>(requested, allowedTotal);
+        Generation::bandQuotas(allowed.data(), quotas.data(), bands, mineCount);
+
+        const std::uint64_t boardKey = rng.next();
+        for (std::size_t band = 0; band < bands; ++band) {
+            Philox4x32 generator = Generation::bandGenerator(boardKey, band);
+
+            const std::uint64_t first = static_cast<std::uint64_t>(band) * Generation::BandRows * width;
+            const std::uint64_t last = std::min(first + static_cast<std::uint64_t>(Generation::BandRows) * width, cellCount);
+            candidates.clear();
+            for (std::uint64_t i = first; i < last; ++i) {
+                if (!marked(i))
+                    candidates.push_back(i);
+            }
+
+            for (std::uint64_t k = 0; k < quotas[band]; ++k) {
+                std::swap(candidates[k], candidates[k + generator.below(candidates.size() - k)]);
+                const std::uint64_t i = candidates[k];
+                cells[cellIndex<L>(static_cast<unsigned int>(i % width), static_cast<unsigned int>(i / width))].setMine(true);
+            }
+        }
+
+        // 4. Count adjacent mines
+        computeAdjacency<L>();
+
+        // 5. Reveal safe zone
+        for (std::uint64_t pos : safeZone) {
+            floodFillReveal<L>(static_cast<unsigned int>(pos), static_cast<unsigned int>(pos >> 32));
+        }
+
+        isInitialized = true;
+    }
+
+    template <CellLayout L>
+    void TiledGame::computeAdjacency() {
+        for (unsigned int y = 0; y < height; ++y) {
+            for (unsigned int x = 0; x < width; ++x) {
+                unsigned int count = 0;
+                for (int dy = -1; dy <= 1; ++dy) {
+                    const unsigned int ny = y + dy;
+                    if (ny >= height) continue;
+                    for (int dx = -1; dx <= 1; ++dx) {
+                        const unsigned int nx = x + dx;
+                        if (nx < width && (dx != 0 || dy != 0) && cells[cellIndex<L>(nx, ny)].hasMine())
+                            ++count;
+                    }
+                }
+                cells[cellIndex<L>(x, y)].setAdjacentMines(count);
+            }
+        }
+    }
+
+    template <CellLayout L>
+    void TiledGame::floodFillReveal(unsigned int x, unsigned int y) {
+        // Base case: already revealed or flagged
+        Cell& cell = cells[cellIndex<L>(x, y)];
+        if (cell.state() != CellState::Hidden) return;
+
+        // Reveal this cell
+        setCellState(cell, CellState::Revealed);
+        if (cell.adjacentMines() != 0 || cell.hasMine()) return;
+
+        // Same explicit stack as Game: cells are revealed when pushed and
+        // only zero cells are pushed
+        fillStack.clear();
+        fillStack.push_back(packPos(x, y));
+
+        while (!fillStack.empty()) {
+            const std::uint64_t current = fillStack.back();
+            fillStack.pop_back();
+            const unsigned int cx = static_cast<unsigned int>(current);
+            const unsigned int cy = static_cast<unsigned int>(current >> 32);
+
+            for (int dy = -1; dy <= 1; ++dy) {
+                const unsigned int ny = cy + dy;
+                if (ny >= height) continue;
+                for (int dx = -1; dx <= 1; ++dx) {
+                    const unsigned int nx = cx + dx;
+                    if (nx >= width) continue;
+
+                    Cell& neighbour = cells[cellIndex<L>(nx, ny)];
+                    if (neighbour.state() != CellState::Hidden) continue;
+
+                    setCellState(neighbour, CellState::Revealed);
+                    if (neighbour.adjacentMines() == 0 && !neighbour.hasMine())
+                        fillStack.push_back(packPos(nx, ny));
+                }
+            }
+        }
+    }
+
+    bool TiledGame::reveal(unsigned int x, unsigned int y) {
+        if (x >= width || y >= height) return true; // ignore out of bounds
+
+        return withLayout(layout, [&](auto tag) {
+            return revealAt<decltype(tag)::value>(x, y);
+        });
+    }
+
+    template <CellLayout L>
+    bool TiledGame::revealAt(unsigned int x, unsigned int y) {
+        if (!isInitialized) {
+            placeMines<L>(x, y);
+        }
+
+        Cell& cell = cells[cellIndex<L>(x, y)];
+        if (cell.state() == CellState::Revealed || cell.state() == CellState::Flagged) return true;
+
+        // If it's a mine, game over
+        if (cell.hasMine()) {
+            setCellState(cell, CellState::Revealed);
+            gameOver = true;
+            return false;
+        }
+
+        floodFillReveal<L>(x, y);
+        return true;
+    }
+
+    void TiledGame::toggleFlag(unsigned int x, unsigned int y) {
+        if (x >= width || y >= height) return;
+
+        Cell& cell = withLayout(layout, [&](auto tag) -> Cell& {
+            return cells[cellIndex<decltype(tag)::value>(x, y)];
+        });
+        const CellState state = cell.state();
+        if (state == CellState::Hidden) {
+            setCellState(cell, CellState::Flagged);
+        }
+        else if (state == CellState::Flagged) {
+            setCellState(cell, CellState::Questioned);
+        }
+        else if (state == CellState::Questioned) {
+            setCellState(cell, CellState::Hidden);
+        }
+    }
+
+    void TiledGame::setCellState(Cell& cell, CellState state) {
+        if (cell.state() == CellState::Flagged) --flagCount;
+        if (state == CellState::Flagged) ++flagCount;
+        if (!cell.hasMine()) {
+            if (cell.state() == CellState::Revealed) --revealedSafeCount;
+            if (state == CellState::Revealed) ++revealedSafeCount;
+        }
+        cell.setState(state);
+    }
+
+    Cell TiledGame::cellAt(unsigned int x, unsigned int y) const {
+        if (x >= width || y >= height)
+            throw std::out_of_range("Cell position outside the board.");
+
+        return withLayout(layout, [&](auto tag) {
+            return cells[cellIndex<decltype(tag)::value>(x, y)];
+        });
+    }
+
+    std::size_t TiledGame::memoryFootprint() const {
+        return sizeof(TiledGame) + cells.capacity() * sizeof(Cell)
+            + (fillStack.capacity() + stencil.capacity() + candidates.capacity()) * sizeof(std::uint64_t);
+    }
+
+    bool TiledGame::checkWin() const {
+        // Win if all non-mine cells are revealed
+        return (revealedSafeCount == (static_cast<std::uint64_t>(width) * height - mineCount));
+    }
+
+    bool TiledGame::isGameOver() const {
+        return gameOver;
+    }
+
+    bool TiledGame::hasEnded() const {
+        return gameOver || checkWin();
+    }
+
+    void TiledGame::setMineDensity(double density) {
+        if (density < 0.0 || density > 1.0)
+            throw std::invalid_argument("Mine density must be between 0 and 1.");
+        mineDensity = density;
+    }
+
+    double TiledGame::getMineDensity() const {
+        return mineDensity;
+    }
+
+    std::uint64_t TiledGame::getMineCount() const {
+        return mineCount;
+    }
+
+    std::int64_t TiledGame::remainingMines() const {
+        return static_cast<std::int64_t>(mineCount) - static_cast<std::int64_t>(flagCount);
+    }
+
+    unsigned int TiledGame::getWidth() const {
+        return width;
+    }
+
+    unsigned int TiledGame::getHeight() const {
+        return height;
+    }
+
+    CellLayout TiledGame::getLayout() const {
+        return layout;
+    }
+
+} // namespace Minesweeper
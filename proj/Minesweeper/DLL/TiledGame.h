@@ -0,0 +1,111 @@
+#pragma once
+#include "API.h"
+#include "Cell.h"
+#include "Random.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace Minesweeper {
+
+    // Order in which TiledGame stores its cells
+    enum class CellLayout : std::uint8_t {
+        RowMajor,  // one row after another, as Game stores them
+        Tiles8,    // 8x8 tiles of 64 bytes (one cache line), tiles in row order
+        Tiles16,   // 16x16 tiles of 256 bytes, tiles in row order
+        ZOrder     // Morton order over the board padded to a power-of-two square
+    };
+
+    // Game backend with a selectable cell layout. In row-major order the
+    // vertical neighbours a flood fill or count visits are a whole row apart,
+    // so on boards a few thousand cells wide every vertical step misses the
+    // cache; tiles and Z-order keep a cell's 3x3 block within one or two
+    // cache lines. Layout arithmetic stays behind the cell accessor, and every
+    // algorithm is compiled once per layout so the choice is made once per
+    // call, not per cell. Boards are generated exactly like Game's, so the
+    // same seed and first click give the same board in every layout.
+    // Z-order pads the board to a power-of-two square; use tiles for boards
+    // much wider than tall or the reverse.
+    class EXPORT_API TiledGame {
+    public:
+        // Initialize a new game with given size and layout. Without a seed
+        // one is drawn from std::random_device.
+        void initialize(unsigned int width, unsigned int height, CellLayout layout = CellLayout::Tiles16);
+        void initialize(unsigned int width, unsigned int height, Seed seed, CellLayout layout = CellLayout::Tiles16);
+
+        // Initialize with a fixed mine layout instead of first-click generation
+        void initializeWithMines(unsigned int width, unsigned int height,
+            const std::vector<std::pair<unsigned int, unsigned int>>& mines,
+            CellLayout layout = CellLayout::Tiles16);
+
+        // Reveal the cell at (x, y); returns false if a mine was revealed
+        bool reveal(unsigned int x, unsigned int y);
+
+        // Toggle flag state on the cell at (x, y)
+        void toggleFlag(unsigned int x, unsigned int y);
+
+        // Check for win/lose condition (all non-mine cells revealed)
+        bool checkWin() const;
+        bool isGameOver() const;
+        bool hasEnded() const;
+
+        // Fraction of cells that get a mine on the next generated board
+        void setMineDensity(double density);
+        double getMineDensity() const;
+        std::uint64_t getMineCount() const;
+
+        // Mines left to flag (mine count minus placed flags; may go negative)
+        std::int64_t remainingMines() const;
+
+        // Accessors
+        unsigned int getWidth() const;
+        unsigned int getHeight() const;
+        CellLayout getLayout() const;
+
+        // Cell at (x, y) in the same packed format Game uses
+        Cell cellAt(unsigned int x, unsigned int y) const;
+
+        // Bytes used by the game object and its buffers
+        std::size_t memoryFootprint() const;
+
+    private:
+        std::vector<Cell> cells;  // in layout order, padded to whole tiles
+        CellLayout layout = CellLayout::RowMajor;
+        unsigned int width = 0, height = 0, safeParam = 2;
+        std::uint64_t tilesPerRow = 0;
+        double mineDensity = 0.175;
+        Xoshiro256 rng;
+        std::uint64_t mineCount = 0;
+        std::uint64_t revealedSafeCount = 0, flagCount = 0;
+        bool isInitialized = false;
+        bool gameOver = false;
+        std::vector<std::uint64_t> fillStack;   // packed (y << 32 | x), reused by floodFillReveal
+        std::vector<std::uint64_t> stencil;     // one bit per row-major cell closed to mines
+        std::vector<std::uint64_t> candidates;  // allowed row-major mine positions
+
+        // Storage index of the cell (x, y) in layout L
+        template <CellLayout L>
+        std::uint64_t cellIndex(unsigned int x, unsigned int y) const;
+
+        // Sizes the buffer for the layout and clears the game state
+        void resetBoard(unsigned int width, unsigned int height, CellLayout layout);
+
+        void setCellState(Cell& cell, CellState state);
+
+        template <CellLayout L>
+        bool revealAt(unsigned int x, unsigned int y);
+
+        // Reveal the cell and, if it has no adjacent mines, its whole zero region
+        template <CellLayout L>
+        void floodFillReveal(unsigned int x, unsigned int y);
+
+        // Fills in adjacentMines for every cell
+        template <CellLayout L>
+        void computeAdjacency();
+
+        // Place mines around a safe zone at the first click position
+        template <CellLayout L>
+        void placeMines(unsigned int safeX, unsigned int safeY);
+    };
+}
@@ -11,6 +11,8 @@ void Config::saveToFile(const std::string& filename) const {
         }
 
         file << "gridSize:" << gridSize << ";\n";
+        file << "seed:" << seed << ";\n";
+        file << "topology:" << topology << ";\n";
 
         if (!file) {
             throw std::ios_base::failure("Failed to write to file.");
@@ -44,6 +46,18 @@ void Config::loadFromFile(const std::string& filename) {
                         throw std::runtime_error("Grid size out of valid range.");
                     }
                 }
+                else if (key == "seed") {
+                    seed = std::stoull(valueStr);
+                }
+                else if (key == "topology") {
+                    int value = std::stoi(valueStr);
+                    if (value >= 0 && value < topologyCount) {
+                        topology = value;
+                    }
+                    else {
+                        throw std::runtime_error("Topology out of valid range.");
+                    }
+                }
             }
         }
 
@@ -52,6 +66,8 @@ void Config::loadFromFile(const std::string& filename) {
     catch (const std::exception& e) {
         std::cerr << "Error loading config: " << e.what() << std::endl;
         gridSize = defaultGridSize; // Fallback default
+        seed = 0;
+        topology = 0;
         updateGridText();
     }
 }
@@ -73,12 +89,22 @@ Config::Config(sf::RenderWindow& window, const sf::Font& font)
     gridText->setFillColor(sf::Color::Yellow);
     updateGridText();
 
+    // Seed text
+    seedText = sf::Text(font, "", 32);
+    seedText->setFillColor(sf::Color::Yellow);
+    updateSeedText();
+
+    // Topology text
+    topologyText = sf::Text(font, "", 32);
+    topologyText->setFillColor(sf::Color::Yellow);
+    updateTopologyText();
+
     // Return button
     returnButton = sf::Text(font, "Return to Menu", 32);
     returnButton->setFillColor(sf::Color::Yellow);
     sf::FloatRect rBounds = returnButton->getLocalBounds();
     returnButton->setOrigin(rBounds.position + rBounds.size / 2.f);
-    returnButton->setPosition({ windowRef.getSize().x / 2.f, 320.f });
+    returnButton->setPosition({ windowRef.getSize().x / 2.f, 430.f });
 
     updateSelectionVisuals();
 }
@@ -97,12 +123,49 @@ void Config::updateGridText() {
     }
 }
 
+void Config::updateSeedText() {
+    if (seedText) {
+        saveToFile();
+
+        std::ostringstream ss;
+        ss << "Seed: ";
+        if (seed == 0)
+            ss << "random";
+        else
+            ss << seed;
+        seedText->setString(ss.str());
+
+        sf::FloatRect bounds = seedText->getLocalBounds();
+        seedText->setOrigin({ bounds.size.x / 2.f, bounds.size.y / 2.f });
+        seedText->setPosition({ windowRef.getSize().x / 2.f, 300.f });
+    }
+}
+
+void Config::updateTopologyText() {
+    if (topologyText) {
+        saveToFile();
+
+        static const char* const names[topologyCount] = { "Square", "Torus", "Hex", "Knight" };
+        topologyText->setString(std::string("Board: ") + names[topology]);
+
+        sf::FloatRect bounds = topologyText->getLocalBounds();
+        topologyText->setOrigin({ bounds.size.x / 2.f, bounds.size.y / 2.f });
+        topologyText->setPosition({ windowRef.getSize().x / 2.f, 360.f });
+    }
+}
+
 void Config::updateSelectionVisuals() {
     if (gridText)
         gridText->setFillColor(selectedIndex == 0 ? sf::Color::Green : sf::Color::Yellow);
 
+    if (seedText)
+        seedText->setFillColor(selectedIndex == 1 ? sf::Color::Green : sf::Color::Yellow);
+
+    if (topologyText)
+        topologyText->setFillColor(selectedIndex == 2 ? sf::Color::Green : sf::Color::Yellow);
+
     if (returnButton)
-        returnButton->setFillColor(selectedIndex == 1 ? sf::Color::Green : sf::Color::Yellow);
+        returnButton->setFillColor(selectedIndex == 3 ? sf::Color::Green : sf::Color::Yellow);
 }
 
 void Config::handleEvent(const sf::Event& event, bool& returnToMenu) {
@@ -110,11 +173,11 @@ void Config::handleEvent(const sf::Event& event, bool& returnToMenu) {
         auto key = event.getIf<sf::Event::KeyPressed>()->code;
 
         if (key == sf::Keyboard::Key::Up) {
-            selectedIndex = (selectedIndex - 1 + 2) % 2;
+            selectedIndex = (selectedIndex - 1 + itemCount) % itemCount;
             updateSelectionVisuals();
         }
         else if (key == sf::Keyboard::Key::Down) {
-            selectedIndex = (selectedIndex + 1) % 2;
+            selectedIndex = (selectedIndex + 1) % itemCount;
             updateSelectionVisuals();
         }
         else if (key == sf::Keyboard::Key::Left && selectedIndex == 0 && gridSize > minSize) {
@@ -125,10 +188,31 @@ void Config::handleEvent(const sf::Event& event, bool& returnToMenu) {
             gridSize++;
             updateGridText();
         }
-        else if (key == sf::Keyboard::Key::Enter && selectedIndex == 1) {
+        else if (key == sf::Keyboard::Key::Left && selectedIndex == 2) {
+            topology = (topology - 1 + topologyCount) % topologyCount;
+            updateTopologyText();
+        }
+        else if (key == sf::Keyboard::Key::Right && selectedIndex == 2) {
+            topology = (topology + 1) % topologyCount;
+            updateTopologyText();
+        }
+        else if (key == sf::Keyboard::Key::Enter && selectedIndex == 3) {
             returnToMenu = true;
         }
     }
+    else if (event.is<sf::Event::TextEntered>() && selectedIndex == 1) {
+        // Seed is typed in as digits; Backspace removes the last one
+        char32_t c = event.getIf<sf::Event::TextEntered>()->unicode;
+
+        if (c >= U'0' && c <= U'9' && seed < 100000000000000000ull) {
+            seed = seed * 10 + (c - U'0');
+            updateSeedText();
+        }
+        else if (c == U'\b') {
+            seed /= 10;
+            updateSeedText();
+        }
+    }
 }
 
 void Config::drawArrows(const sf::Text& targetText, float yOffset) {
@@ -166,11 +250,29 @@ void Config::draw() {
         }
     }
 
+    if (seedText) {
+        const auto& text = seedText.value();
+        windowRef.draw(text);
+
+        if (selectedIndex == 1 && fontRef) {
+            drawArrows(text, 0.f);
+        }
+    }
+
+    if (topologyText) {
+        const auto& text = topologyText.value();
+        windowRef.draw(text);
+
+        if (selectedIndex == 2 && fontRef) {
+            drawArrows(text, 0.f);
+        }
+    }
+
     if (returnButton) {
         const auto& text = returnButton.value();
         windowRef.draw(text);
 
-        if (selectedIndex == 1 && fontRef) {
+        if (selectedIndex == 3 && fontRef) {
             drawArrows(text, -12.f);
         }
     }
@@ -180,6 +282,14 @@ int Config::getGridSize() const {
     return gridSize;
 }
 
+std::uint64_t Config::getSeed() const {
+    return seed;
+}
+
+Minesweeper::TopologyKind Config::getTopology() const {
+    return static_cast<Minesweeper::TopologyKind>(topology);
+}
+
 void Config::setSelectedIndex(int id) {
     selectedIndex = id;
     updateSelectionVisuals();
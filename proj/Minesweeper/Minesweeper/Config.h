@@ -2,6 +2,8 @@
 #include <SFML/Graphics.hpp>
 #include <string>
 #include <optional>
+#include <cstdint>
+#include "Topology.h"
 
 class Config {
 public:
@@ -11,9 +13,18 @@ public:
     void setSelectedIndex(int id);
     void draw();
     int getGridSize() const;
+    std::uint64_t getSeed() const; // 0 means a random board
+    Minesweeper::TopologyKind getTopology() const;
+
+    // Range of selectable grid sizes
+    static constexpr int minSize = 5;
+    static constexpr int maxSize = 10;
+
 
 private:
     void updateGridText();
+    void updateSeedText();
+    void updateTopologyText();
     void updateSelectionVisuals();
     void drawArrows(const sf::Text& targetText, float yOffset);
     void saveToFile(const std::string& filename = "config.txt") const;
@@ -24,10 +35,14 @@ private:
 
     std::optional<sf::Text> gridLabel;
     std::optional<sf::Text> gridText;
+    std::optional<sf::Text> seedText;
+    std::optional<sf::Text> topologyText;
     std::optional<sf::Text> returnButton;
 
     int defaultGridSize = 7, gridSize = defaultGridSize;
-    const int minSize = 5;
-    const int maxSize = 10;
+    std::uint64_t seed = 0;
+    int topology = 0; // index into TopologyKind
+    static constexpr int topologyCount = 4;
+    const int itemCount = 4;
     int selectedIndex = 0;
 };
@@ -113,6 +113,8 @@ void Menu::handleEvent(const sf::Event& event) {
                 std::cout << "Start Game selected. Grid size: "
                     << config->getGridSize() << "x" << config->getGridSize() << "\n";
                 gridSize = config->getGridSize();
+                seed = config->getSeed();
+                topology = config->getTopology();
                 startGame = true;
                 break;
             case 1:
@@ -227,3 +229,11 @@ bool Menu::shouldStartGame() const {
 unsigned int Menu::getGridSize() const {
     return gridSize;
 }
+
+std::uint64_t Menu::getSeed() const {
+    return seed;
+}
+
+Minesweeper::TopologyKind Menu::getTopology() const {
+    return topology;
+}
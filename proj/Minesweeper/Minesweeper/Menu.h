@@ -17,6 +17,8 @@ public:
 
     bool shouldStartGame() const;
     unsigned int getGridSize() const;
+    std::uint64_t getSeed() const;
+    Minesweeper::TopologyKind getTopology() const;
     int selectedIndex = 0; // Index of the currently selected button
 
 private:
@@ -40,6 +42,8 @@ private:
     std::vector<std::optional<sf::Text>*> menuButtons; // vector of pointers to the optionals
 
     unsigned int gridSize = 7;
+    std::uint64_t seed = 0;
+    Minesweeper::TopologyKind topology = Minesweeper::TopologyKind::Square;
 
     bool startGame = false;
     bool inCredits = false;
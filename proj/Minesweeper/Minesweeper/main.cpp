@@ -1,7 +1,265 @@
 #include <SFML/Graphics.hpp>
+#include "BasicGame.h"
 #include "GameLogic.h"
 #include "Menu.h"
 #include <iostream>
+#include <filesystem>
+#include <fstream>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+
+// Unfinished game saved when the window is closed, resumed on next start
+static const char* const savePath = "savegame.bin";
+
+static const int tileSize = 32;
+
+// Cells a huge reveal opens per frame on a Game board
+static const std::uint64_t revealSlice = std::uint64_t(1) << 16;
+
+// Plays one board until the player goes back to the menu or closes the
+// window. Written once for Game and every BasicGame size and topology;
+// the topology decides where tiles are drawn and which cell a click hits.
+template <typename GameType>
+static void playGame(sf::RenderWindow& window, Menu& menu, const sf::Texture& tileset, GameType& game)
+{
+    using Topology = typename GameType::Topology;
+
+    // Game opens big regions a slice per frame; BasicGame boards are small
+    // enough to reveal in one go
+    constexpr bool sliced = requires(GameType& g) { g.continueReveal(revealSlice); };
+
+    std::cout << "Board seed: " << game.getSeed() << "\n";
+
+    const unsigned int boardWidth = game.getGrid().width();
+    const unsigned int boardHeight = game.getGrid().height();
+
+    // Calculate centered position for the grid
+    sf::Vector2u windowSize = window.getSize();
+    int gridPixelWidth = static_cast<int>((boardWidth + Minesweeper::rowShift<Topology>(1)) * tileSize);
+    int gridPixelHeight = boardHeight * tileSize;
+
+    float offsetX = (windowSize.x - gridPixelWidth) / 2.f;
+    float offsetY = (windowSize.y - gridPixelHeight) / 2.f;
+
+    // One textured quad (two triangles) per cell; only the quads of
+    // cells reported in a change set get their texture updated
+    sf::VertexArray tiles(sf::PrimitiveType::Triangles, static_cast<std::size_t>(boardWidth) * boardHeight * 6);
+    const float tilePx = static_cast<float>(tileSize);
+    const sf::Vector2f corners[6] = { {0, 0}, {tilePx, 0}, {0, tilePx}, {0, tilePx}, {tilePx, 0}, {tilePx, tilePx} };
+
+    auto setTile = [&](std::uint64_t index, int tileIndex) {
+        const sf::Vector2f textureOrigin = { static_cast<float>(tileIndex * tileSize), 0.f };
+        for (int k = 0; k < 6; ++k)
+            tiles[index * 6 + k].texCoords = textureOrigin + corners[k];
+    };
+
+    auto tileFor = [](const Minesweeper::Cell& cell) {
+        switch (cell.state()) {
+        case Minesweeper::CellState::Flagged:    return 1;
+        case Minesweeper::CellState::Questioned: return 2;
+        case Minesweeper::CellState::Revealed:
+            return cell.hasMine() ? 3 : 4 + static_cast<int>(cell.adjacentMines());
+        default:                                 return 0;
+        }
+    };
+
+    const auto initialGrid = game.getGrid();
+    for (unsigned int y = 0; y < boardHeight; ++y) {
+        for (unsigned int x = 0; x < boardWidth; ++x) {
+            const std::uint64_t index = static_cast<std::uint64_t>(y) * boardWidth + x;
+            const float column = static_cast<float>(x) + Minesweeper::rowShift<Topology>(y);
+            const sf::Vector2f origin = { offsetX + column * tileSize, offsetY + static_cast<float>(y * tileSize) };
+            for (int k = 0; k < 6; ++k)
+                tiles[index * 6 + k].position = origin + corners[k];
+            setTile(index, tileFor(initialGrid.at(x, y)));
+        }
+    }
+
+    Minesweeper::ChangeSet changes;
+    bool waitingForRestart = false;
+
+    auto applyChanges = [&] {
+        const auto grid = game.getGrid();
+        for (const auto& change : changes)
+            setTile(change.index, tileFor(grid.at(change.index % boardWidth, change.index / boardWidth)));
+        changes.clear();
+    };
+
+    // 4) Game loop
+    while (window.isOpen()) {
+        while (auto event = window.pollEvent()) {
+            if (event->is<sf::Event::Closed>()) {
+                if constexpr (sliced)
+                    game.continueReveal(~std::uint64_t(0));
+                if (!game.hasEnded()) {
+                    try {
+                        game.saveSnapshot(std::string(savePath));
+                    }
+                    catch (const std::exception& e) {
+                        std::cerr << "Could not save game: " << e.what() << "\n";
+                    }
+                }
+                window.close();
+            }
+
+            // Ctrl+Z / Ctrl+Y step through moves, also after a lost game
+            auto key = event->getIf<sf::Event::KeyPressed>();
+            if (key && key->control && key->code == sf::Keyboard::Key::Z) {
+                game.undo(&changes);
+            }
+            else if (key && key->control && key->code == sf::Keyboard::Key::Y) {
+                game.redo(&changes);
+            }
+            else if (!game.hasEnded()) {
+                if (event->is<sf::Event::MouseButtonPressed>()) {
+                    auto mouse = event->getIf<sf::Event::MouseButtonPressed>();
+                    // Clicks left of or above the board wrap to huge values and are ignored
+                    const unsigned int MouseY = static_cast<unsigned int>(
+                        static_cast<int>(std::floor((mouse->position.y - offsetY) / tileSize)));
+                    const unsigned int MouseX = static_cast<unsigned int>(static_cast<int>(std::floor(
+                        (mouse->position.x - offsetX) / tileSize - Minesweeper::rowShift<Topology>(MouseY))));
+
+                    if (mouse->button == sf::Mouse::Button::Left) {
+                        bool safe;
+                        if constexpr (sliced)
+                            safe = game.beginReveal(MouseX, MouseY, revealSlice, &changes);
+                        else
+                            safe = game.reveal(MouseX, MouseY, &changes);
+                        if (!safe)
+                            std::cout << "You hit a mine!\n";
+                    }
+                    else if (mouse->button == sf::Mouse::Button::Right) {
+                        game.toggleFlag(MouseX, MouseY, &changes);
+                    }
+                    else if (mouse->button == sf::Mouse::Button::Middle) {
+                        bool safe = game.chord(MouseX, MouseY, &changes);
+                        if (!safe)
+                            std::cout << "You hit a mine!\n";
+                    }
+                }
+                else if (key && key->code == sf::Keyboard::Key::F) {
+                    game.autoFlag(&changes);
+                }
+            }
+            else {
+                if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Enter)) {
+                    waitingForRestart = true;
+                    menu.endGame();
+                }
+            }
+
+            applyChanges();
+        }
+
+        if (waitingForRestart)
+            return;
+
+        if constexpr (sliced) {
+            if (game.isRevealPending()) {
+                game.continueReveal(revealSlice, &changes);
+                applyChanges();
+            }
+        }
+
+        window.clear();
+
+        // 5) Draw game grid
+        window.draw(tiles, &tileset);
+
+        if (game.hasEnded()) {
+            std::string message = game.checkWin() ? "You won!" : "Game Over!";
+            menu.drawGameOverMessage(message);
+        }
+
+        window.display();
+    }
+}
+
+// Runs play(game) on a BasicGame for the given size and topology, picking
+// the specialization at run time; sizes without one use the dynamic Game,
+// which only knows the square topology
+template <unsigned int Size = Config::minSize, typename Play>
+static void withGame(unsigned int size, Minesweeper::TopologyKind topology, Play&& play)
+{
+    using Minesweeper::BasicGame;
+    using Minesweeper::TopologyKind;
+
+    if constexpr (Size <= Config::maxSize) {
+        if (size != Size) {
+            withGame<Size + 1>(size, topology, play);
+            return;
+        }
+
+        switch (topology) {
+        case TopologyKind::Torus:  { BasicGame<Size, Size, Minesweeper::Torus> game;  play(game); break; }
+        case TopologyKind::Hex:    { BasicGame<Size, Size, Minesweeper::Hex> game;    play(game); break; }
+        case TopologyKind::Knight: { BasicGame<Size, Size, Minesweeper::Knight> game; play(game); break; }
+        default:                   { BasicGame<Size, Size> game;                      play(game); break; }
+        }
+    }
+    else {
+        Minesweeper::Game game;
+        play(game);
+    }
+}
+
+template <unsigned int W, unsigned int H, typename Topology>
+static void startBoard(Minesweeper::BasicGame<W, H, Topology>& game, unsigned int, std::uint64_t seed)
+{
+    if (seed != 0)
+        game.initialize(Minesweeper::Seed{ seed });
+    else
+        game.initialize();
+}
+
+static void startBoard(Minesweeper::Game& game, unsigned int size, std::uint64_t seed)
+{
+    if (seed != 0)
+        game.initialize(size, Minesweeper::Seed{ seed });
+    else
+        game.initialize(size);
+}
+
+// Resumes the game saved in savePath, if there is a readable one; the file
+// is removed either way
+static bool resumeSavedGame(sf::RenderWindow& window, Menu& menu, const sf::Texture& tileset)
+{
+    if (!std::filesystem::exists(savePath))
+        return false;
+
+    std::vector<std::uint8_t> bytes;
+    {
+        std::ifstream file(savePath, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    std::filesystem::remove(savePath);
+
+    Minesweeper::SnapshotHeader header;
+    if (bytes.size() < sizeof(header)) {
+        std::cerr << "Could not resume saved game: snapshot is truncated\n";
+        return false;
+    }
+    std::memcpy(&header, bytes.data(), sizeof(header));
+
+    // The header tells which game type wrote the board
+    bool resumed = false;
+    const auto topology = static_cast<Minesweeper::TopologyKind>(header.topology);
+    const unsigned int size = header.width == header.height ? header.width : 0;
+    withGame(size, topology, [&](auto& game) {
+        try {
+            game.loadSnapshot(bytes.data(), bytes.size());
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Could not resume saved game: " << e.what() << "\n";
+            return;
+        }
+        resumed = true;
+        std::cout << "Resumed saved game\n";
+        playGame(window, menu, tileset, game);
+    });
+    return resumed;
+}
 
 int main()
 {
@@ -30,9 +288,8 @@ int main()
 
             if (!window.isOpen()) return 0;
 
-            // 3) Initialize game
+            // 3) Initialize game: resume the saved one if there is one
             const unsigned int size = menu.getGridSize();
-            const int tileSize = 32;
 
             sf::Texture tileset;
             if (!tileset.loadFromFile("assets/tileset.png")) {
@@ -40,86 +297,13 @@ int main()
                 return -1;
             }
 
-            Minesweeper::Game game;
-            game.initialize(size);
-            sf::Sprite tileSprite(tileset);
-
-            // Calculate centered position for the grid
-            sf::Vector2u windowSize = window.getSize();
-            int gridPixelWidth = size * tileSize;
-            int gridPixelHeight = size * tileSize;
-
-            float offsetX = (windowSize.x - gridPixelWidth) / 2.f;
-            float offsetY = (windowSize.y - gridPixelHeight) / 2.f;
-
-            bool waitingForRestart = false;
+            if (resumeSavedGame(window, menu, tileset))
+                continue;
 
-            // 4) Game loop
-            while (window.isOpen()) {
-                while (auto event = window.pollEvent()) {
-                    if (event->is<sf::Event::Closed>())
-                        window.close();
-                    if (!game.hasEnded()) {
-                        if (event->is<sf::Event::MouseButtonPressed>()) {
-                            auto mouse = event->getIf<sf::Event::MouseButtonPressed>();
-                            int MouseX = (mouse->position.x - static_cast<int>(offsetX)) / tileSize;
-                            int MouseY = (mouse->position.y - static_cast<int>(offsetY)) / tileSize;
-
-                            if (mouse->button == sf::Mouse::Button::Left) {
-                                bool safe = game.reveal(MouseX, MouseY);
-                                if (!safe)
-                                    std::cout << "You hit a mine!\n";
-                            }
-                            else if (mouse->button == sf::Mouse::Button::Right) {
-                                game.toggleFlag(MouseX, MouseY);
-                            }
-                        }
-                    }
-                    else {
-                        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Enter)) {
-                            waitingForRestart = true;
-                            menu.endGame();
-                        }
-                    }
-                }
-
-                if (waitingForRestart)
-                    break;
-
-                window.clear();
-
-                // 5) Draw game grid
-                const auto& grid = game.getGrid();
-                for (int y = 0; y < size; ++y) {
-                    for (int x = 0; x < size; ++x) {
-                        const auto& cell = grid[y][x];
-
-                        int tileIndex = 0;
-                        switch (cell.state) {
-                        case Minesweeper::CellState::Hidden:     tileIndex = 0; break;
-                        case Minesweeper::CellState::Flagged:    tileIndex = 1; break;
-                        case Minesweeper::CellState::Questioned: tileIndex = 2; break;
-                        case Minesweeper::CellState::Revealed:
-                            tileIndex = cell.hasMine ? 3 : 4 + cell.adjacentMines;
-                            break;
-                        }
-
-                        tileSprite.setTextureRect(sf::IntRect({ tileIndex * tileSize, 0 }, { tileSize, tileSize }));
-                        tileSprite.setPosition({
-                            offsetX + static_cast<float>(x * tileSize),
-                            offsetY + static_cast<float>(y * tileSize)
-                            });
-                        window.draw(tileSprite);
-                    }
-                }
-
-                if (game.hasEnded()) {
-                    std::string message = game.checkWin() ? "You won!" : "Game Over!";
-                    menu.drawGameOverMessage(message);
-                }
-
-                window.display();
-            }
+            withGame(size, menu.getTopology(), [&](auto& game) {
+                startBoard(game, size, menu.getSeed());
+                playGame(window, menu, tileset, game);
+            });
         }
     }
     catch (const std::exception& e) {